@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executor.h"
+#include "generators.h"
+#include "log.h"
+#include "node.h"
+#include "parser.h"
+#include "register.h"
+#include "tokenizer.h"
+
+using namespace cat;
+using namespace cat::bench;
+
+namespace {
+
+struct Result {
+  std::string name;
+  size_t scale;
+  size_t samples;
+  double median;
+  double min;
+  double mean;
+};
+
+struct Options {
+  std::string json;
+  std::string filter;
+  double budget{0.2};
+};
+
+// Runs benchmark until the time budget is spent, setup is not measured
+class Runner {
+public:
+  explicit Runner(const Options &options_) : m_options(options_) {}
+
+  template <typename TState>
+  void Run(const std::string &name_, size_t scale_,
+           const std::function<TState()> &setup_,
+           const std::function<void(TState &)> &fn_) {
+    if (name_.find(m_options.filter) == std::string::npos)
+      return;
+
+    using TClock = std::chrono::steady_clock;
+
+    const size_t minSamples = 3;
+    const size_t maxSamples = 1000;
+
+    std::vector<double> samples;
+    double total{};
+
+    while (samples.size() < maxSamples &&
+           (samples.size() < minSamples || total < m_options.budget * 1e9)) {
+      TState state = setup_();
+
+      auto start = TClock::now();
+      fn_(state);
+      auto end = TClock::now();
+
+      double ns = std::chrono::duration<double, std::nano>(end - start).count();
+      samples.push_back(ns);
+      total += ns;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    Result result{name_,
+                  scale_,
+                  samples.size(),
+                  samples[samples.size() / 2],
+                  samples.front(),
+                  total / samples.size()};
+
+    std::fprintf(stderr, "%-28s %8zu %8zu %14.0f ns\n", name_.c_str(), scale_,
+                 result.samples, result.median);
+
+    m_results.push_back(std::move(result));
+  }
+
+  template <typename TState>
+  void Run(const std::string &name_, size_t scale_, TState state_,
+           const std::function<void(TState &)> &fn_) {
+    Run<TState>(
+        name_, scale_, [&]() { return state_; }, fn_);
+  }
+
+  std::string Json() const {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < m_results.size(); ++i) {
+      const Result &result = m_results[i];
+      out << (i ? "," : "") << "\n    {\"name\": \"" << result.name
+          << "\", \"scale\": " << result.scale
+          << ", \"samples\": " << result.samples
+          << ", \"median_ns\": " << uint64_t(result.median)
+          << ", \"min_ns\": " << uint64_t(result.min)
+          << ", \"mean_ns\": " << uint64_t(result.mean) << "}";
+    }
+
+    out << "\n  ]\n}\n";
+
+    return out.str();
+  }
+
+private:
+  Options m_options;
+  std::vector<Result> m_results;
+};
+
+//-----------------------------------------------------------------------------------------
+void bench_parsing(Runner &runner_) {
+  for (size_t scale : {16, 32, 64}) {
+    // Tokenizer expects sources without comments
+    runner_.Run<std::string>("tokenize", scale, make_source(scale, 0),
+                             [](std::string &src_) {
+                               Tokenizer::Process(src_);
+                             });
+
+    runner_.Run<std::string>("parse", scale, make_source(scale, 0),
+                             [](std::string &src_) {
+                               Parser parser;
+                               parser.ParseSource(src_);
+                             });
+
+    runner_.Run<std::string>("parse_commented", scale, make_source(scale, 256),
+                             [](std::string &src_) {
+                               Parser parser;
+                               parser.ParseSource(src_);
+                             });
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void bench_structure(Runner &runner_) {
+  for (size_t scale : {16, 64, 256}) {
+    runner_.Run<Node>(
+        "add_arrow", scale, [scale]() { return make_chain(scale); },
+        [scale](Node &node_) {
+          for (size_t i = 0; i + 2 < scale; ++i)
+            node_.AddArrow(Arrow(object_name(i), object_name(i + 2)));
+        });
+
+    runner_.Run<Node>("query_arrows", scale, make_dag(scale, 4 * scale, 1),
+                      [](Node &node_) {
+                        node_.QueryArrows(Arrow("*", "*").AsQuery());
+                        node_.QueryArrows(
+                            Arrow(object_name(0), "*", "*").AsQuery());
+                      });
+
+    runner_.Run<Node>("query_arrows_dense", scale,
+                      make_dense(std::min<size_t>(scale, 64)),
+                      [](Node &node_) {
+                        node_.QueryArrows(Arrow("*", "*").AsQuery());
+                      });
+
+    runner_.Run<Node>("query_nodes", scale, make_chain(scale),
+                      [](Node &node_) { node_.QueryNodes("*"); });
+
+    runner_.Run<Node>("verify", scale, make_chain(scale),
+                      [scale](Node &node_) {
+                        node_.Verify(
+                            Arrow(object_name(0), object_name(scale - 1)));
+                      });
+  }
+
+  for (size_t scale : {8, 16, 32}) {
+    runner_.Run<Node>("solve_compositions_chain", scale, make_chain(scale),
+                      [](Node &node_) { node_.SolveCompositions(); });
+
+    runner_.Run<Node>("solve_compositions_dag", scale,
+                      make_dag(scale, 2 * scale, 2),
+                      [](Node &node_) { node_.SolveCompositions(); });
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void bench_sequences(Runner &runner_) {
+  for (size_t scale : {8, 16, 32}) {
+    Node chain = make_chain(scale);
+    chain.SolveCompositions();
+
+    runner_.Run<Node>("solve_sequence", scale, chain, [scale](Node &node_) {
+      node_.SolveSequence(object_name(0), object_name(scale - 1));
+    });
+  }
+
+  for (size_t scale : {6, 8, 10}) {
+    Node dag = make_dag(scale, 2 * scale, 3);
+
+    runner_.Run<Node>("solve_sequences", scale, dag, [scale](Node &node_) {
+      node_.SolveSequences(object_name(0), object_name(scale - 1));
+    });
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void bench_functors(Runner &runner_) {
+  for (size_t scale : {8, 16, 32}) {
+    Node lcat = make_lcat(3, scale, 6, 4);
+
+    Arrow::List first = lcat.QueryArrows(Arrow("C0", "C1", "*").AsQuery());
+    Arrow::List second = lcat.QueryArrows(Arrow("C1", "C2", "*").AsQuery());
+    if (first.empty() || second.empty())
+      continue;
+
+    using TPair = std::pair<Arrow, Arrow>;
+    runner_.Run<TPair>("compose", scale, {second.front(), first.front()},
+                       [](TPair &pair_) { pair_.first.Compose(pair_.second); });
+
+    runner_.Run<Node>("verify_functor", scale, lcat, [&](Node &node_) {
+      node_.Verify(first.front());
+    });
+  }
+
+  for (size_t scale : {2, 3, 4}) {
+    Node lcat = make_lcat(2, scale, 0, 5);
+
+    runner_.Run<Node>("propose_arrows", scale, lcat, [](Node &node_) {
+      node_.ProposeArrows("C0", "C1");
+    });
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void bench_executor(Runner &runner_) {
+  Register reg;
+  Executor executor(reg);
+
+  for (size_t scale : {8, 16, 32}) {
+    Node chain = make_chain(scale);
+    chain.SolveCompositions();
+
+    for (const Arrow &arrow : chain.QueryArrows(Arrow("*", "*").AsQuery()))
+      reg.Reg<int, int>(arrow, [](int arg_) { return arg_ + 1; });
+
+    int value{};
+
+    runner_.Run<Node *>("exec", scale, &chain, [&](Node *&node_) {
+      node_->SetNodeValue(object_name(0), ++value);
+      executor.Exec(*node_);
+    });
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void usage() {
+  std::cerr << "Usage: cat_bench [--json FILE] [--filter NAME] "
+               "[--budget SECONDS]\n";
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+int main(int argc_, char **argv_) {
+  Options options;
+
+  for (int i = 1; i < argc_; ++i) {
+    std::string arg = argv_[i];
+    bool hasValue = i + 1 < argc_;
+
+    if (arg == "--json" && hasValue) {
+      options.json = argv_[++i];
+    } else if (arg == "--filter" && hasValue) {
+      options.filter = argv_[++i];
+    } else if (arg == "--budget" && hasValue) {
+      options.budget = std::atof(argv_[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  set_log_mode(ELogMode::eQuiet);
+
+  Runner runner(options);
+
+  bench_parsing(runner);
+  bench_structure(runner);
+  bench_sequences(runner);
+  bench_functors(runner);
+  bench_executor(runner);
+
+  if (options.json.empty()) {
+    std::cout << runner.Json();
+    return 0;
+  }
+
+  std::ofstream file(options.json);
+  file << runner.Json();
+  if (!file) {
+    std::cerr << "Can't write " << options.json << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "generators.h"
+
+#include <set>
+#include <utility>
+
+namespace cat {
+namespace bench {
+
+//-----------------------------------------------------------------------------------------
+std::string object_name(size_t index_) { return "o" + std::to_string(index_); }
+
+//-----------------------------------------------------------------------------------------
+static Node make_objects(const Node::NName &name_, size_t objects_,
+                         const std::string &prefix_ = "o") {
+  Node ret(name_, Node::EType::eSCategory);
+
+  for (size_t i = 0; i < objects_; ++i)
+    ret.AddNode(Node(prefix_ + std::to_string(i), Node::EType::eObject));
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Node make_chain(size_t objects_) {
+  Node ret = make_objects("chain", objects_);
+
+  for (size_t i = 1; i < objects_; ++i)
+    ret.AddArrow(Arrow(object_name(i - 1), object_name(i)));
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Node make_tree(size_t objects_, size_t fanout_) {
+  Node ret = make_objects("tree", objects_);
+
+  for (size_t i = 1; i < objects_; ++i)
+    ret.AddArrow(Arrow(object_name((i - 1) / fanout_), object_name(i)));
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Node make_dag(size_t objects_, size_t arrows_, uint32_t seed_) {
+  Node ret = make_objects("dag", objects_);
+  if (objects_ < 2)
+    return ret;
+
+  Random random(seed_);
+
+  std::set<std::pair<size_t, size_t>> pairs;
+  size_t limit = objects_ * (objects_ - 1) / 2;
+
+  while (pairs.size() < std::min(arrows_, limit)) {
+    size_t source = random.Next(objects_ - 1);
+    size_t target = source + 1 + random.Next(objects_ - source - 1);
+
+    if (pairs.emplace(source, target).second)
+      ret.AddArrow(Arrow(object_name(source), object_name(target)));
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Node make_dense(size_t objects_) {
+  Node ret = make_objects("dense", objects_);
+
+  for (size_t i = 0; i < objects_; ++i) {
+    for (size_t j = i + 1; j < objects_; ++j)
+      ret.AddArrow(Arrow(object_name(i), object_name(j)));
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Node make_lcat(size_t categories_, size_t objects_, size_t functors_,
+               uint32_t seed_) {
+  Node ret("lcat", Node::EType::eLCategory);
+
+  auto fnCategory = [](size_t index_) { return "C" + std::to_string(index_); };
+  auto fnObject = [](size_t category_, size_t index_) {
+    return "c" + std::to_string(category_) + "_" + std::to_string(index_);
+  };
+
+  for (size_t i = 0; i < categories_; ++i)
+    ret.AddNode(make_objects(fnCategory(i), objects_,
+                             "c" + std::to_string(i) + "_"));
+
+  if (categories_ < 2)
+    return ret;
+
+  Random random(seed_);
+
+  std::set<std::pair<size_t, size_t>> pairs;
+  size_t limit = categories_ * (categories_ - 1);
+
+  while (pairs.size() < std::min(functors_, limit)) {
+    size_t source = random.Next(categories_);
+    size_t target = random.Next(categories_);
+    if (source == target || !pairs.emplace(source, target).second)
+      continue;
+
+    Arrow functor(fnCategory(source), fnCategory(target));
+
+    size_t shift = random.Next(objects_);
+    for (size_t i = 0; i < objects_; ++i)
+      functor.EmplaceArrow(fnObject(source, i),
+                           fnObject(target, (i + shift) % objects_));
+
+    ret.AddArrow(functor);
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+std::string make_source(size_t objects_, size_t comment_) {
+  const std::string comment =
+      comment_ ? "/* " + std::string(comment_, 'c') + " */\n" : "";
+
+  std::string ret = comment + "SCAT chain\n{\n" + comment + "   OBJ ";
+  for (size_t i = 0; i < objects_; ++i)
+    ret += (i ? ", " : "") + object_name(i);
+  ret += ";\n";
+
+  for (size_t i = 1; i < objects_; ++i) {
+    ret += comment + "   " + object_name(i - 1) + " -[*]-> " +
+           object_name(i) + " {};\n";
+  }
+
+  ret += "}\n";
+
+  return ret;
+}
+
+} // namespace bench
+} // namespace cat
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "node.h"
+
+namespace cat {
+namespace bench {
+
+/**
+ * @brief The Random class is a reproducible source of numbers. Only the
+ * engine is used, distributions of the standard library differ between
+ * implementations
+ */
+class Random {
+public:
+  explicit Random(uint32_t seed_) : m_engine(seed_) {}
+
+  /**
+   * @brief Returns number in [0, bound_)
+   * @param bound_ - upper bound
+   * @return Number
+   */
+  size_t Next(size_t bound_) { return bound_ ? m_engine() % bound_ : 0; }
+
+private:
+  std::mt19937 m_engine;
+};
+
+/**
+ * @brief Returns name of generated object
+ * @param index_ - index of object
+ * @return Name
+ */
+std::string object_name(size_t index_);
+
+/**
+ * @brief Makes small category of objects o0 -> o1 -> ... -> on-1
+ * @param objects_ - number of objects
+ * @return Category
+ */
+Node make_chain(size_t objects_);
+
+/**
+ * @brief Makes small category of a tree, parent of object i is (i - 1) /
+ * fanout_
+ * @param objects_ - number of objects
+ * @param fanout_ - number of children of a node
+ * @return Category
+ */
+Node make_tree(size_t objects_, size_t fanout_);
+
+/**
+ * @brief Makes small category of random acyclic graph, arrows go from lower
+ * to higher indices
+ * @param objects_ - number of objects
+ * @param arrows_ - number of arrows
+ * @param seed_ - seed
+ * @return Category
+ */
+Node make_dag(size_t objects_, size_t arrows_, uint32_t seed_);
+
+/**
+ * @brief Makes small category with arrows between all pairs of objects in
+ * the order of indices
+ * @param objects_ - number of objects
+ * @return Category
+ */
+Node make_dense(size_t objects_);
+
+/**
+ * @brief Makes large category of small categories without arrows and
+ * functors between them, each mapping objects one to one with a random
+ * shift
+ * @param categories_ - number of small categories
+ * @param objects_ - number of objects of a small category
+ * @param functors_ - number of functors
+ * @param seed_ - seed
+ * @return Category
+ */
+Node make_lcat(size_t categories_, size_t objects_, size_t functors_,
+               uint32_t seed_);
+
+/**
+ * @brief Makes source of a small category chain with a comment before every
+ * statement
+ * @param objects_ - number of objects
+ * @param comment_ - length of comments, no comments if zero
+ * @return Source
+ */
+std::string make_source(size_t objects_, size_t comment_);
+
+} // namespace bench
+} // namespace cat
@@ -1,14 +1,19 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "cat_export.h"
+#include "counters.h"
+#include "hash.h"
+#include "memory_report.h"
 
 namespace cat {
 class Node;
+class Register;
 
 /**
  * @brief The Arrow class represents morphisms and functors
@@ -34,7 +39,9 @@ public:
   Arrow &operator=(const Arrow &) = default;
 
   using Vec = std::vector<Arrow>;
-  using List = std::list<Arrow>;
+  // Counts its allocations, see "CountingAllocator". It is not
+  // std::list<Arrow>, code converting to it needs to copy
+  using List = std::list<Arrow, CountingAllocator<Arrow>>;
   using AName = std::string;
 
   /**
@@ -152,6 +159,15 @@ public:
    */
   std::optional<Node> Map(const std::optional<Node> &node_) const;
 
+  /**
+   * @brief Maps node with function of given register
+   * @param node_ - node for mapping
+   * @param register_ - register
+   * @return Mapped node
+   */
+  std::optional<Node> Map(const std::optional<Node> &node_,
+                          const Register &register_) const;
+
   /**
    * @brief Inverses arrow
    */
@@ -170,7 +186,8 @@ public:
   std::string AsQuery() const;
 
   /**
-   * @brief Checks associativity of arrows
+   * @brief Checks associativity of arrows. Names of arrows are ignored,
+   * internal arrows are compared as unordered mappings
    * @param arrow - arrow for associativity check
    * @return True if associative
    */
@@ -194,13 +211,72 @@ public:
    */
   std::optional<Arrow> Compose(const Arrow &arrow_) const;
 
+  /**
+   * @brief Returns structural hash over name, source, target and internal
+   * arrows. The value is cached until the arrow is modified
+   * @return Hash value
+   */
+  std::size_t Hash() const;
+
+  /**
+   * @brief Moves internal arrows into the pool of shared immutable mappings.
+   * Arrows with identical internal arrows share one copy of them, the copy is
+   * detached again on modification
+   */
+  void Intern();
+
+  /**
+   * @brief Counts distinct mappings in the pool
+   * @return Number of mappings
+   */
+  static size_t CountInterned();
+
+  /**
+   * @brief Adds heap bytes of names and internal arrows to the report,
+   * mappings shared by interning are counted once
+   * @param usage_ - report
+   * @param visited_ - shared buffers already counted
+   */
+  void MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const;
+
 private:
   std::optional<Node> singleMapImpl(const std::string &name_) const;
 
+  /**
+   * @brief Returns hash of the mapping i.e. source, target and unordered
+   * internal mappings without names
+   * @return Hash value
+   */
+  std::size_t mappingHash() const;
+
+  /**
+   * @brief Invalidates cached hashes
+   */
+  void resetHash();
+
+  /**
+   * @brief Returns internal arrows
+   * @return Arrows
+   */
+  const List &arrows() const;
+
+  /**
+   * @brief Returns internal arrows for modification. Shared arrows are copied
+   * @return Arrows
+   */
+  List &mutableArrows();
+
   std::string m_source;
   std::string m_target;
   AName m_name;
-  List m_arrows;
+  std::shared_ptr<List> m_arrows;
+  bool m_interned{};
+  HashCache m_hash;
+  HashCache m_mappingHash;
+};
+
+struct CAT_EXPORT ArrowKeyHasher {
+  std::size_t operator()(const Arrow &arrow_) const;
 };
 
 } // namespace cat
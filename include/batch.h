@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "cat_export.h"
+#include "node.h"
+
+namespace cat {
+
+/**
+ * @brief The Span class is a non-owning view of contiguous values (a subset
+ * of C++20 std::span)
+ */
+template <typename T> class Span {
+public:
+  Span() = default;
+  Span(T *data_, std::size_t size_) : m_data(data_), m_size(size_) {}
+
+  template <typename TVector>
+  Span(TVector &vector_) : m_data(vector_.data()), m_size(vector_.size()) {}
+
+  T *data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  T *begin() const { return m_data; }
+  T *end() const { return m_data + m_size; }
+
+  T &operator[](std::size_t index_) const { return m_data[index_]; }
+
+private:
+  T *m_data{};
+  std::size_t m_size{};
+};
+
+/**
+ * @brief Column of values of one type. Alternatives follow ESetTypes
+ */
+using TColumn =
+    std::variant<std::vector<double>, std::vector<float>, std::vector<int>,
+                 std::vector<std::string>, std::vector<Tensor>>;
+
+/**
+ * @brief Returns number of values in column
+ * @param column_ - column
+ * @return Number of values
+ */
+CAT_EXPORT std::size_t column_size(const TColumn &column_);
+
+/**
+ * @brief Returns value of column
+ * @param column_ - column
+ * @param index_ - index of value
+ * @return Value
+ */
+CAT_EXPORT TSetValue column_value(const TColumn &column_, std::size_t index_);
+
+/**
+ * @brief Makes column from values of the same type
+ * @param values_ - values
+ * @return Column or nothing if types of values differ
+ */
+CAT_EXPORT std::optional<TColumn>
+make_column(const std::vector<TSetValue> &values_);
+
+/**
+ * @brief Makes column of repeated value
+ * @param value_ - value
+ * @param size_ - number of values
+ * @return Column
+ */
+CAT_EXPORT TColumn make_column(const TSetValue &value_, std::size_t size_);
+} // namespace cat
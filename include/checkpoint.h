@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "cat_export.h"
+#include "value_store.h"
+
+namespace cat {
+
+/**
+ * @brief The Checkpoint class is a saved state of a run: values of slots and
+ * the number of hops done. It is bound to the node and the plan by their
+ * hashes, so a run is resumed only with the same graph
+ */
+class CAT_EXPORT Checkpoint {
+public:
+  /**
+   * @brief Checkpoint constructor
+   * @param hash_ - hash of node and plan
+   * @param cursor_ - number of hops done
+   * @param store_ - values of slots
+   */
+  Checkpoint(size_t hash_, size_t cursor_, ValueStore store_);
+
+  /**
+   * @brief Writes checkpoint to file. The file is replaced only once the new
+   * one is written completely
+   * @param path_ - file path
+   * @param hash_ - hash of node and plan
+   * @param cursor_ - number of hops done
+   * @param store_ - values of slots
+   * @return True if successful
+   */
+  static bool Save(const std::string &path_, size_t hash_, size_t cursor_,
+                   const ValueStore &store_);
+
+  /**
+   * @brief Reads checkpoint from file
+   * @param path_ - file path
+   * @return Checkpoint or nothing if there is no valid checkpoint
+   */
+  static std::optional<Checkpoint> Load(const std::string &path_);
+
+  /**
+   * @brief Deletes checkpoint file
+   * @param path_ - file path
+   */
+  static void Remove(const std::string &path_);
+
+  size_t Hash() const;
+  size_t Cursor() const;
+  ValueStore &Store();
+
+private:
+  size_t m_hash;
+  size_t m_cursor;
+  ValueStore m_store;
+};
+} // namespace cat
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "cat_export.h"
+
+namespace cat {
+/**
+ * @brief Operations counted while counting is enabled
+ * eComparisons - comparisons of nodes
+ * eAllocations - allocations by containers of nodes and arrows
+ * eAllocatedBytes - bytes allocated by containers of nodes and arrows
+ * eTokenizerCalls - runs of tokenizer
+ * eArrowScans - arrows visited by queries and checks of arrows
+ */
+enum class ECounter {
+  eComparisons,
+  eAllocations,
+  eAllocatedBytes,
+  eTokenizerCalls,
+  eArrowScans,
+  eCount
+};
+
+/**
+ * @brief Enables counting of operations, disabled by default so that
+ * threads don't share counters in production
+ * @param enabled_ - counting is enabled
+ */
+CAT_EXPORT void set_counting(bool enabled_);
+CAT_EXPORT bool get_counting();
+
+namespace detail {
+// Checked inline by count_operation, disabled counting costs a relaxed load
+// on hot paths. Changed only by set_counting
+inline std::atomic<bool> g_counting{false};
+} // namespace detail
+
+/**
+ * @brief Adds to counter whether counting is enabled or not
+ * @param counter_ - counter
+ * @param count_ - number of operations
+ */
+CAT_EXPORT void add_operation(ECounter counter_, uint64_t count_);
+
+/**
+ * @brief Adds to counter if counting is enabled
+ * @param counter_ - counter
+ * @param count_ - number of operations
+ */
+inline void count_operation(ECounter counter_, uint64_t count_ = 1) {
+  if (detail::g_counting.load(std::memory_order_relaxed))
+    add_operation(counter_, count_);
+}
+
+CAT_EXPORT uint64_t get_counter(ECounter counter_);
+CAT_EXPORT void reset_counters();
+
+// Called on every allocation and deallocation of containers of nodes and
+// arrows
+using TAllocationHook = void (*)(std::size_t bytes_, bool allocated_);
+
+/**
+ * @brief Sets hook of allocations, no hook by default
+ * @param hook_ - hook or nullptr
+ */
+CAT_EXPORT void set_allocation_hook(TAllocationHook hook_);
+
+/**
+ * @brief Counts allocation and passes it to the hook
+ * @param bytes_ - bytes
+ * @param allocated_ - true for allocation, false for deallocation
+ */
+CAT_EXPORT void count_allocation(std::size_t bytes_, bool allocated_);
+
+/**
+ * @brief The CountingAllocator class is the standard allocator reporting to
+ * count_allocation. It costs a call next to every allocation, which is small
+ * compared to the allocation itself
+ */
+template <typename T> class CountingAllocator {
+public:
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <typename U> CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(std::size_t count_) {
+    T *ret = std::allocator<T>().allocate(count_);
+    count_allocation(count_ * sizeof(T), true);
+    return ret;
+  }
+
+  void deallocate(T *ptr_, std::size_t count_) {
+    count_allocation(count_ * sizeof(T), false);
+    std::allocator<T>().deallocate(ptr_, count_);
+  }
+
+  template <typename U> bool operator==(const CountingAllocator<U> &) const {
+    return true;
+  }
+
+  template <typename U> bool operator!=(const CountingAllocator<U> &) const {
+    return false;
+  }
+};
+} // namespace cat
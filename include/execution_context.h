@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "cat_export.h"
+#include "executor.h"
+#include "register.h"
+#include "thread_pool.h"
+
+namespace cat {
+
+/**
+ * @brief The ExecutionContext class owns everything needed to execute nodes:
+ * register of functions, thread pool, executor with its plan cache and
+ * statistics. Contexts are independent of each other; the default one is
+ * made of the global Register, ThreadPool and Executor instances
+ */
+class CAT_EXPORT ExecutionContext {
+public:
+  struct Stats {
+    size_t execs{};
+    size_t failures{};
+  };
+
+  /**
+   * @brief ExecutionContext constructor
+   * @param threads_ - number of threads of the pool
+   */
+  explicit ExecutionContext(
+      size_t threads_ = std::thread::hardware_concurrency());
+
+  ExecutionContext(const ExecutionContext &) = delete;
+  ExecutionContext &operator=(const ExecutionContext &) = delete;
+
+  /**
+   * @brief Returns default context
+   * @return Context
+   */
+  static ExecutionContext &Default();
+
+  Register &GetRegister() const;
+  ThreadPool &GetPool() const;
+  Executor &GetExecutor() const;
+
+  /**
+   * @brief Executes node incrementally, see Executor::Exec
+   * @param node_ - node
+   * @return True if successful
+   */
+  bool Exec(Node &node_);
+
+  /**
+   * @brief Executes node on the thread pool of the context
+   * @param node_ - node
+   * @return True if successful
+   */
+  bool ExecParallel(Node &node_);
+
+  /**
+   * @brief Executes functors between internal categories of the node and
+   * the categories themselves, see Executor::ExecHierarchy
+   * @param node_ - node of categories
+   * @return True if successful
+   */
+  bool ExecHierarchy(Node &node_);
+
+  /**
+   * @brief Returns statistics of executions
+   * @return Statistics
+   */
+  Stats GetStats() const;
+
+private:
+  ExecutionContext(Register &register_, ThreadPool &pool_,
+                   Executor &executor_);
+
+  bool count(bool ok_);
+
+  // Owned parts, empty in the default context
+  std::unique_ptr<Register> m_ownRegister;
+  std::unique_ptr<ThreadPool> m_ownPool;
+  std::unique_ptr<Executor> m_ownExecutor;
+
+  Register &m_register;
+  ThreadPool &m_pool;
+  Executor &m_executor;
+
+  std::atomic<size_t> m_execs{};
+  std::atomic<size_t> m_failures{};
+};
+} // namespace cat
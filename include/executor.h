@@ -1,18 +1,312 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "batch.h"
 #include "cat_export.h"
 #include "node.h"
+#include "register.h"
+#include "tracer.h"
+#include "value_store.h"
 
 namespace cat {
 
+class ThreadPool;
+
+/**
+ * @brief The Plan struct is a compiled run of the executor over a node: the
+ * order of hops between nodes with resolved arrows and functions
+ */
+struct CAT_EXPORT Plan {
+  struct Hop {
+    // Source node slot
+    size_t source;
+    // Target node slot
+    size_t target;
+    Arrow arrow;
+    Register::TFn fn;
+    // Internal nodes of the source have to be mapped by the arrow
+    bool structural;
+    // Batch kernel, empty if the arrow has none
+    Register::TBatchFn batch{};
+    // Typed function, empty if the function is not typed
+    Register::TInvoker invoker{};
+    // Asynchronous function, empty if the function is synchronous
+    Register::TAsyncFn async{};
+  };
+
+  /**
+   * @brief Returns slot of the node
+   * @param name_ - node name
+   * @return Slot
+   */
+  std::optional<size_t> Slot(const Node::NName &name_) const;
+
+  /**
+   * @brief Applies function of hop not mapping internal nodes
+   * @param hop_ - hop
+   * @param values_ - slot values
+   * @return True if successful
+   */
+  bool Apply(const Hop &hop_, std::vector<TSetValue> &values_) const;
+
+  /**
+   * @brief Returns hash of slots and hops
+   * @return Hash value
+   */
+  size_t Hash() const;
+
+  std::vector<Node::NName> slots;
+  std::vector<Hop> hops;
+};
+
 class CAT_EXPORT Executor {
 
 public:
+  // Columns of values by node name
+  using TBatch = std::map<Node::NName, TColumn>;
+  // Versions of slot values seen by the last run of plan
+  using TVersions = std::vector<uint64_t>;
+  // Values of plan slots
+  using TRecord = std::vector<TSetValue>;
+
+  /**
+   * @brief Executor constructor
+   * @param register_ - register of functions
+   */
+  explicit Executor(Register &register_);
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  /**
+   * @brief Returns executor of the default execution context
+   * @return Executor
+   */
   static Executor &Inst();
 
+  /**
+   * @brief Returns register of functions
+   * @return Register
+   */
+  Register &GetRegister() const;
+
+  /**
+   * @brief Sets tracer recording timings of compiles, runs and arrow
+   * functions. Without tracer nothing is measured
+   * @param tracer_ - tracer or nullptr, has to outlive its use
+   */
+  void SetTracer(Tracer *tracer_);
+
+  /**
+   * @brief Returns tracer
+   * @return Tracer or nullptr
+   */
+  Tracer *GetTracer() const;
+
+  /**
+   * @brief Executes node. Plans are cached by node structure, repeated
+   * executions recompute only nodes depending on values changed since the
+   * previous one. Executions of one executor are serialized
+   * @param node_ - node
+   * @return True if successful
+   */
   bool Exec(Node &node_);
 
+  /**
+   * @brief Drops cached plans
+   */
+  void ResetCache();
+
+  /**
+   * @brief Sets maximum number of cached plans, the least recently used one
+   * is dropped first
+   * @param capacity_ - number of plans, zero disables caching
+   */
+  void SetCacheCapacity(size_t capacity_);
+
+  /**
+   * @brief Executes node on the thread pool, see Run
+   * @param node_ - node
+   * @param pool_ - thread pool
+   * @return True if successful
+   */
+  bool Exec(Node &node_, ThreadPool &pool_);
+
+  /**
+   * @brief Executes two levels of categories: functors between internal
+   * categories of the node and objects of every internal category. A functor
+   * maps values of objects of its source to objects of its target in place,
+   * in parallel on the pool. Each object mapping uses function registered
+   * for it or the function of the functor. Internal categories are executed
+   * before their values are mapped further and once they are mapped to
+   * @param node_ - node of categories
+   * @param pool_ - thread pool
+   * @return True if successful
+   */
+  bool ExecHierarchy(Node &node_, ThreadPool &pool_);
+
+  /**
+   * @brief Compiles execution plan. Sequences between initial and terminal
+   * nodes, arrows and registered functions are resolved once. Types of
+   * typed functions are checked along sequences. Hops shared by several
+   * sequences are planned once unless their source or target is rewritten
+   * in between
+   * @param node_ - node
+   * @return Plan or nothing if the node can't be executed
+   */
+  std::optional<Plan> Compile(const Node &node_) const;
+
+  /**
+   * @brief Compiles execution plan keeping only requested intermediate
+   * results, see Fuse
+   * @param node_ - node
+   * @param outputs_ - nodes to be written besides ends of sequences
+   * @return Plan or nothing if the node can't be executed
+   */
+  std::optional<Plan> Compile(const Node &node_,
+                              const std::vector<Node::NName> &outputs_) const;
+
+  /**
+   * @brief Fuses consecutive hops of linear sequences into one hop calling
+   * composed function. A hop is fused with the next one if its target is
+   * only written by it, only read by the next hop and not requested as
+   * output. Asynchronous functions are not fused. Fused intermediate nodes
+   * keep their values
+   * @param plan_ - plan
+   * @param outputs_ - nodes to be kept
+   * @return Fused plan
+   */
+  Plan Fuse(const Plan &plan_, const std::vector<Node::NName> &outputs_) const;
+
+  /**
+   * @brief Runs compiled plan over the node it was compiled for (or a node of
+   * the same structure)
+   * @param plan_ - plan
+   * @param node_ - node
+   * @return True if successful
+   */
+  bool Run(const Plan &plan_, Node &node_) const;
+
+  /**
+   * @brief Runs compiled plan on the thread pool. Hops are scheduled as soon
+   * as the hops they depend on are done, so independent branches run
+   * concurrently. Results are the same as of the serial run
+   * @param plan_ - plan
+   * @param node_ - node
+   * @param pool_ - thread pool
+   * @return True if successful
+   */
+  bool Run(const Plan &plan_, Node &node_, ThreadPool &pool_) const;
+
+  /**
+   * @brief Runs compiled plan incrementally. Hops run if their source value
+   * changed since the previous run or their target value is not the one
+   * written by it; changes propagate downstream. Falls back to full run for
+   * plans mapping internal nodes or writing a node more than once
+   * @param plan_ - plan
+   * @param node_ - node
+   * @param versions_ - versions of the previous run, updated by the run
+   * @return True if successful
+   */
+  bool Run(const Plan &plan_, Node &node_, TVersions &versions_) const;
+
+  /**
+   * @brief Runs compiled plan over values of the store, the node is not
+   * touched. Plans mapping internal nodes change the node and can't be run
+   * this way
+   * @param plan_ - plan
+   * @param store_ - values of slots of the plan, see ValueStore::Load
+   * @return True if successful
+   */
+  bool Run(const Plan &plan_, ValueStore &store_) const;
+
+  /**
+   * @brief Runs compiled plan saving checkpoints to file every interval_
+   * hops. If the file holds a checkpoint of the same node, plan and input
+   * values, the run resumes from it. The file is removed once the run is
+   * done. The run fails if a checkpoint can't be saved. Plans mapping
+   * internal nodes can't be checkpointed
+   * @param plan_ - plan
+   * @param node_ - node
+   * @param path_ - checkpoint file path
+   * @param interval_ - number of hops between checkpoints
+   * @return True if successful
+   */
+  bool Run(const Plan &plan_, Node &node_, const std::string &path_,
+           size_t interval_) const;
+
+  /**
+   * @brief Runs compiled plan over columns of input values. Hops use batch
+   * kernels of arrows if there are any and registered functions value by
+   * value otherwise. Nodes without input column take their current value.
+   * Plans mapping internal nodes can't be run in batches
+   * @param plan_ - plan
+   * @param node_ - node the plan was compiled for
+   * @param inputs_ - input columns of the same size
+   * @return Columns of all nodes of the plan or nothing on failure
+   */
+  std::optional<TBatch> RunBatch(const Plan &plan_, const Node &node_,
+                                 const TBatch &inputs_) const;
+
+  /**
+   * @brief Runs compiled plan over records of slot values on the calling
+   * thread. Up to inFlight_ records are in progress at once: while an
+   * asynchronous function of one record is pending, the others advance.
+   * Plans mapping internal nodes can't be run this way
+   * @param plan_ - plan
+   * @param records_ - records
+   * @param inFlight_ - maximum number of records in progress
+   * @return Records with results, nothing for failed ones
+   */
+  std::vector<std::optional<TRecord>> RunAsync(const Plan &plan_,
+                                               std::vector<TRecord> records_,
+                                               size_t inFlight_) const;
+
 private:
-  Executor() = default;
+
+  struct Cached {
+    // Structure of the node the plan was compiled for, hashes may collide
+    Node structure;
+    size_t hash;
+    size_t generation;
+    std::optional<Plan> plan;
+    TVersions versions;
+  };
+
+  // Most recently used plans first
+  using TCache = std::list<Cached>;
+
+  static bool load_values(const Plan &plan_, const Node &node_,
+                          std::vector<TSetValue> &values_);
+  static bool run_hop(const Plan &plan_, const Plan::Hop &hop_, Node &node_,
+                      std::vector<TSetValue> &values_,
+                      const Register &register_, Tracer *tracer_);
+  static void store_values(const Plan &plan_, Node &node_,
+                           std::vector<TSetValue> &values_);
+  static Plan::Hop fuse_hops(const Plan &plan_, const Plan::Hop &first_,
+                             const Plan::Hop &second_);
+  bool map_functor(Node &node_, const Plan &plan_, const Plan::Hop &hop_,
+                   const Register::TSnapshot &functions_,
+                   ThreadPool &pool_) const;
+  static void load_versions(const Plan &plan_, const Node &node_,
+                            TVersions &versions_);
+
+  void evict_plan();
+
+  Register &m_register;
+  TCache m_cache;
+  std::unordered_multimap<size_t, TCache::iterator> m_cacheIndex;
+  size_t m_cacheCapacity{64};
+  std::mutex m_mutex;
+  std::atomic<Tracer *> m_tracer{};
 };
 } // namespace cat
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace cat {
+
+/**
+ * @brief Mixes bits of hash value
+ * @param value_ - hash value
+ * @return Mixed value
+ */
+inline std::size_t hash_mix(std::size_t value_) {
+  value_ ^= value_ >> 33;
+  value_ *= 0xff51afd7ed558ccdULL;
+  value_ ^= value_ >> 33;
+  value_ *= 0xc4ceb9fe1a85ec53ULL;
+  value_ ^= value_ >> 33;
+  return value_;
+}
+
+/**
+ * @brief Combines hash values (order sensitive)
+ * @param seed_ - accumulated hash
+ * @param value_ - hash value
+ */
+inline void hash_combine(std::size_t &seed_, std::size_t value_) {
+  seed_ ^= hash_mix(value_) + 0x9e3779b97f4a7c15ULL + (seed_ << 6) +
+           (seed_ >> 2);
+}
+
+/**
+ * @brief The HashCache class keeps lazily computed hash value. Concurrent
+ * readers may compute the value simultaneously, they all store the same result
+ */
+class HashCache {
+public:
+  HashCache() = default;
+  HashCache(const HashCache &cache_)
+      : m_value(cache_.m_value.load(std::memory_order_relaxed)) {}
+
+  HashCache &operator=(const HashCache &cache_) {
+    m_value.store(cache_.m_value.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    return *this;
+  }
+
+  /**
+   * @brief Returns cached value or computes it
+   * @param fn_ - hash function
+   * @return Hash value
+   */
+  template <typename Fn> std::size_t Get(Fn &&fn_) const {
+    std::size_t value = m_value.load(std::memory_order_relaxed);
+    if (value == 0) {
+      // Zero marks the empty cache
+      value = fn_();
+      value = value == 0 ? 1 : value;
+      m_value.store(value, std::memory_order_relaxed);
+    }
+
+    return value;
+  }
+
+  /**
+   * @brief Invalidates cached value
+   */
+  void Reset() { m_value.store(0, std::memory_order_relaxed); }
+
+private:
+  mutable std::atomic<std::size_t> m_value{};
+};
+} // namespace cat
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include "cat_export.h"
+#include "node.h"
+
+namespace cat {
+
+/**
+ * @brief The Memo class keeps results of a function by argument value. Number
+ * of results is bounded, the least recently used one is evicted first
+ */
+class CAT_EXPORT Memo {
+public:
+  struct Stats {
+    size_t hits{};
+    size_t misses{};
+    size_t evictions{};
+    size_t size{};
+
+    /**
+     * @brief Returns share of lookups served from memo
+     * @return Hit rate in [0, 1]
+     */
+    double HitRate() const;
+  };
+
+  /**
+   * @brief Memo constructor
+   * @param capacity_ - maximum number of results
+   */
+  explicit Memo(size_t capacity_);
+
+  Memo(const Memo &) = delete;
+  Memo &operator=(const Memo &) = delete;
+
+  /**
+   * @brief Looks result up and marks it as recently used
+   * @param arg_ - argument
+   * @return Result or nothing if there is no result for the argument
+   */
+  std::optional<TSetValue> Find(const TSetValue &arg_);
+
+  /**
+   * @brief Stores result. Results of arguments not equal to themselves, like
+   * NaN, are not stored
+   * @param arg_ - argument
+   * @param ret_ - result
+   */
+  void Insert(const TSetValue &arg_, const TSetValue &ret_);
+
+  /**
+   * @brief Returns statistics
+   * @return Statistics
+   */
+  Stats GetStats() const;
+
+  /**
+   * @brief Drops results and statistics
+   */
+  void Clear();
+
+private:
+  using TEntries = std::list<std::pair<TSetValue, TSetValue>>;
+
+  size_t m_capacity;
+  TEntries m_entries;
+  std::unordered_map<TSetValue, TEntries::iterator> m_index;
+  Stats m_stats;
+  mutable std::mutex m_mutex;
+};
+} // namespace cat
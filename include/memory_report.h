@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <string>
+
+#include "cat_export.h"
+
+namespace cat {
+/**
+ * @brief The MemoryUsage struct is an estimate of heap bytes held by a node.
+ * Sizes of allocator blocks are estimated from the standard containers,
+ * buffers shared between nodes are counted once
+ */
+struct CAT_EXPORT MemoryUsage {
+  std::size_t nodes{};    // Entries of node tables and codomains
+  std::size_t arrows{};   // Entries of arrow lists of nodes
+  std::size_t mappings{}; // Nested mappings of arrows and functors
+  std::size_t names{};    // Names of nodes and arrows
+  std::size_t values{};   // Strings and tensor buffers of values
+
+  /**
+   * @brief Returns sum of all parts
+   * @return Bytes
+   */
+  std::size_t Total() const;
+
+  MemoryUsage &operator+=(const MemoryUsage &other_);
+};
+
+// Shared buffers already counted by a report
+using TMemoryVisited = std::set<const void *>;
+
+/**
+ * @brief Returns bytes of string buffer, strings in the small buffer take
+ * nothing
+ * @param string_ - string
+ * @return Bytes
+ */
+CAT_EXPORT std::size_t heap_size(const std::string &string_);
+
+/**
+ * @brief Returns bytes of an element of node based container i.e. list, set
+ * or map
+ * @param value_ - size of value
+ * @param links_ - number of pointers of container node
+ * @return Bytes
+ */
+CAT_EXPORT std::size_t heap_node_size(std::size_t value_, std::size_t links_);
+
+/**
+ * @brief Returns bytes of shared object made by std::make_shared
+ * @param value_ - size of object
+ * @return Bytes
+ */
+CAT_EXPORT std::size_t heap_shared_size(std::size_t value_);
+} // namespace cat
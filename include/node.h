@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <optional>
@@ -10,14 +12,24 @@
 
 #include "arrow.h"
 #include "cat_export.h"
+#include "hash.h"
 #include "log.h"
+#include "tensor.h"
 #include "tokenizer.h"
 
 namespace cat {
 class Node;
-
-enum class ESetTypes : unsigned char { eDouble = 0, eFloat, eInt, eString };
-using TSetValue = std::variant<double, float, int, std::string>;
+class SolverControl;
+class ThreadPool;
+
+enum class ESetTypes : unsigned char {
+  eDouble = 0,
+  eFloat,
+  eInt,
+  eString,
+  eTensor
+};
+using TSetValue = std::variant<double, float, int, std::string, Tensor>;
 using FunctionName = std::string;
 using Function = std::pair<FunctionName, TSetValue>;
 
@@ -33,8 +45,12 @@ public:
   Node &operator=(Node &&) = default;
   Node &operator=(const Node &) = default;
 
-  using Set = std::set<Node>;
-  using Map = std::map<Node, Set>;
+  // Containers of nodes count their allocations, see "CountingAllocator".
+  // They are not std::set<Node> and std::map<Node, Set>, code converting to
+  // those needs to copy
+  using Set = std::set<Node, std::less<Node>, CountingAllocator<Node>>;
+  using Map = std::map<Node, Set, std::less<Node>,
+                       CountingAllocator<std::pair<const Node, Set>>>;
   using Vec = std::vector<Node>;
   using List = std::list<Node>;
   using PairSet = std::pair<Node, Set>;
@@ -163,6 +179,29 @@ public:
    */
   void ReplaceNode(const Node &node_);
 
+  /**
+   * @brief Finds internal node by name
+   * @param name_ - node name
+   * @return Node or nullptr if there is no such node
+   */
+  const Node *FindNode(const NName &name_) const;
+
+  /**
+   * @brief Sets value of internal node in place
+   * @param name_ - node name
+   * @param value_ - value
+   * @return True if successful
+   */
+  bool SetNodeValue(const NName &name_, TSetValue value_);
+
+  /**
+   * @brief Changes internal node in place. The function must not rename it
+   * @param name_ - node name
+   * @param fn_ - function changing the node
+   * @return True if the node exists
+   */
+  bool UpdateNode(const NName &name_, const std::function<void(Node &)> &fn_);
+
   /**
    * @brief Erases all nodes
    */
@@ -269,11 +308,13 @@ public:
    * @param from_ - source node of the sequences
    * @param to_ - target node of the sequences
    * @param length_ - match for length
+   * @param control_ - solver limits
    * @return Sequences of nodes
    */
   std::list<std::list<Node::NName>>
   SolveSequences(const Node::NName &from_, const Node::NName &to_,
-                 std::optional<size_t> length_ = std::optional<size_t>()) const;
+                 std::optional<size_t> length_ = std::optional<size_t>(),
+                 SolverControl *control_ = nullptr) const;
 
   /**
    * @brief Maps sequence of nodes onto sequence of arrows
@@ -291,26 +332,70 @@ public:
    * @brief Creates a set of all possible arrows
    * @param from_ - source node for arrows
    * @param to_ - target node for arrows
+   * @param control_ - solver limits
    * @return Set of arrows corresponding to different mappings between nodes
    */
-  Arrow::List ProposeArrows(const Node::NName &from_, const Node::NName &to_);
+  Arrow::List ProposeArrows(const Node::NName &from_, const Node::NName &to_,
+                            SolverControl *control_ = nullptr);
+
+  /**
+   * @brief Finds all valid arrows between two nodes. Objects are assigned
+   * incrementally (most constrained first) and every partial assignment is
+   * checked against the arrows of the target, so invalid branches are pruned
+   * at the first morphism that can not be preserved. With the limit objects
+   * are assigned in the order of "ProposeArrows" instead
+   * @param from_ - source node for arrows
+   * @param to_ - target node for arrows
+   * @param matchCount_ - match count limit
+   * @return First valid arrows in the order of "ProposeArrows"
+   */
+  Arrow::List
+  FindFunctors(const Node::NName &from_, const Node::NName &to_,
+               std::optional<size_t> matchCount_ = std::optional<size_t>()) const;
 
   /**
    * @brief Solves determination problem
    * @param AB - arrow from A to B
    * @param AC - arrow from A to C
+   * @param control_ - solver limits
    * @return Arrow from B to C
    */
   Arrow::List SolveDetermination(const Arrow::AName &AB,
-                                 const Arrow::AName &AC);
+                                 const Arrow::AName &AC,
+                                 SolverControl *control_ = nullptr);
 
   /**
    * @brief Solves choice problem
    * @param BC - arrow from B to C
    * @param AC - arrow from A to C
+   * @param control_ - solver limits
    * @return Arrow from A to B
    */
-  Arrow::List SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC);
+  Arrow::List SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC,
+                          SolverControl *control_ = nullptr);
+
+  /**
+   * @brief Solution callback. Returning false stops the search
+   */
+  using TSolutionFn = std::function<bool(const Arrow &)>;
+
+  /**
+   * @brief Solves choice problem in parallel. Candidates are split into chunks
+   * shared by the workers of the pool and the calling thread. The search stops
+   * as soon as enough solutions are found
+   * @param BC - arrow from B to C
+   * @param AC - arrow from A to C
+   * @param pool_ - thread pool
+   * @param matchCount_ - match count limit
+   * @param onSolution_ - callback invoked (serially) for every solution found
+   * @param control_ - solver limits
+   * @return Arrows from A to B in the order of the serial search
+   */
+  Arrow::List
+  SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC, ThreadPool &pool_,
+              std::optional<size_t> matchCount_ = std::optional<size_t>(),
+              const TSolutionFn &onSolution_ = TSolutionFn(),
+              SolverControl *control_ = nullptr);
 
   /**
    * @brief Returns node type
@@ -329,12 +414,50 @@ public:
    */
   void SetValue(const TSetValue &value_);
 
+  /**
+   * @brief Returns version of value. Every value assignment gets a new
+   * version unique across nodes, copies of node keep the version
+   * @return Version, zero for value which was never set
+   */
+  uint64_t Version() const;
+
   /**
    * @brief Returns value
    * @return Value
    */
   const TSetValue &GetValue() const;
 
+  /**
+   * @brief Returns structural hash over name, type, internal nodes and arrows.
+   * Values are not taken into account. The hash is cached until the node is
+   * modified
+   * @return Hash value
+   */
+  std::size_t Hash() const;
+
+  /**
+   * @brief Compares what the structural hash is computed over i.e. name,
+   * type, internal nodes and arrows regardless of their order
+   * @param node_ - node
+   * @return True if structures are the same
+   */
+  bool SameStructure(const Node &node_) const;
+
+  /**
+   * @brief Returns estimate of heap bytes held by the node, split into node
+   * table, arrow lists, nested mappings, names and values. Internal nodes are
+   * included, buffers shared between them are counted once
+   * @return Report
+   */
+  MemoryUsage MemoryReport() const;
+
+  /**
+   * @brief Adds heap bytes held by the node to the report
+   * @param usage_ - report
+   * @param visited_ - shared buffers already counted
+   */
+  void MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const;
+
 private:
   /**
    * @brief Node structure validation
@@ -354,6 +477,8 @@ private:
   NName m_name;
   EType m_type;
   TSetValue m_value;
+  uint64_t m_version{};
+  HashCache m_hash;
 };
 
 struct CAT_EXPORT NodeKeyHasher {
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "cat_export.h"
+#include "executor.h"
+#include "queue.h"
+
+namespace cat {
+
+/**
+ * @brief The Pipeline class streams records through a compiled plan. Every
+ * node written by the plan is a stage running on its own thread, stages are
+ * linked by bounded lock-free queues. A full queue stalls the stage feeding
+ * it, so a slow stage holds back the stages before it down to Push
+ */
+class CAT_EXPORT Pipeline {
+public:
+  // Values of plan slots
+  using TRecord = std::vector<TSetValue>;
+
+  /**
+   * @brief Creates pipeline and starts its stages
+   * @param plan_ - plan not mapping internal nodes
+   * @param capacity_ - capacity of queues between stages
+   * @return Pipeline or nullptr if the plan can't be streamed
+   */
+  static std::unique_ptr<Pipeline> Create(const Plan &plan_,
+                                          size_t capacity_ = 1024);
+
+  ~Pipeline();
+
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+
+  /**
+   * @brief Makes record of current node values
+   * @param node_ - node the plan was compiled for
+   * @return Record or nothing if the node lacks nodes of the plan
+   */
+  std::optional<TRecord> MakeRecord(const Node &node_) const;
+
+  /**
+   * @brief Pushes record, waits while the pipeline is full
+   * @param record_ - record
+   * @return False if the pipeline is closed or the record doesn't fit the plan
+   */
+  bool Push(TRecord record_);
+
+  /**
+   * @brief Pops processed record, waits while there is none. Records leave
+   * in the order they were pushed
+   * @return Record or nothing if the pipeline is closed and drained
+   */
+  std::optional<TRecord> Pop();
+
+  /**
+   * @brief Closes input. Records pushed before are still processed
+   */
+  void Close();
+
+  /**
+   * @brief Returns number of stages
+   * @return Number of stages
+   */
+  size_t Stages() const;
+
+  /**
+   * @brief Returns number of records dropped after failed functions
+   * @return Number of records
+   */
+  size_t Dropped() const;
+
+  /**
+   * @brief Returns plan of pipeline
+   * @return Plan
+   */
+  const Plan &GetPlan() const;
+
+private:
+  Pipeline(const Plan &plan_, size_t capacity_);
+
+  void stage(size_t index_);
+  bool pop(size_t index_, TRecord &record_);
+  bool push(size_t index_, TRecord &record_);
+
+  Plan m_plan;
+  // Hops of every stage
+  std::vector<std::vector<size_t>> m_stages;
+
+  MpmcQueue<TRecord> m_input;
+  MpmcQueue<TRecord> m_output;
+  std::vector<std::unique_ptr<SpscQueue<TRecord>>> m_links;
+
+  // Stages which finished, they are closed in order
+  std::atomic<size_t> m_finished{};
+  std::atomic<bool> m_closed{};
+  std::atomic<size_t> m_pushing{};
+  std::atomic<bool> m_stop{};
+  std::atomic<size_t> m_dropped{};
+
+  std::vector<std::thread> m_threads;
+};
+} // namespace cat
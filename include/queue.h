@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace cat {
+
+/**
+ * @brief Returns power of two not less than value
+ * @param value_ - value
+ * @return Power of two
+ */
+inline size_t queue_capacity(size_t value_) {
+  size_t ret = 1;
+  while (ret < value_)
+    ret <<= 1;
+  return ret;
+}
+
+/**
+ * @brief The SpscQueue class is a bounded lock-free queue of one producer and
+ * one consumer thread
+ */
+template <typename T> class SpscQueue {
+public:
+  /**
+   * @brief SpscQueue constructor
+   * @param capacity_ - minimum capacity, rounded up to power of two
+   */
+  explicit SpscQueue(size_t capacity_)
+      : m_mask(queue_capacity(capacity_) - 1),
+        m_cells(std::make_unique<T[]>(m_mask + 1)) {}
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  /**
+   * @brief Pushes value unless the queue is full
+   * @param value_ - value, moved from only if pushed
+   * @return True if pushed
+   */
+  bool TryPush(T &value_) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+      return false;
+
+    m_cells[tail & m_mask] = std::move(value_);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops value unless the queue is empty
+   * @param value_ - popped value
+   * @return True if popped
+   */
+  bool TryPop(T &value_) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+
+    value_ = std::move(m_cells[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns capacity
+   * @return Capacity
+   */
+  size_t Capacity() const { return m_mask + 1; }
+
+private:
+  const size_t m_mask;
+  std::unique_ptr<T[]> m_cells;
+  alignas(64) std::atomic<size_t> m_head{};
+  alignas(64) std::atomic<size_t> m_tail{};
+};
+
+/**
+ * @brief The MpmcQueue class is a bounded lock-free queue of any number of
+ * producer and consumer threads. Every cell carries a sequence number telling
+ * whether it is ready for the next push or pop
+ */
+template <typename T> class MpmcQueue {
+public:
+  /**
+   * @brief MpmcQueue constructor
+   * @param capacity_ - minimum capacity, rounded up to power of two
+   */
+  explicit MpmcQueue(size_t capacity_)
+      : m_mask(queue_capacity(capacity_) - 1),
+        m_cells(std::make_unique<Cell[]>(m_mask + 1)) {
+    for (size_t i = 0; i <= m_mask; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MpmcQueue(const MpmcQueue &) = delete;
+  MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+  /**
+   * @brief Pushes value unless the queue is full
+   * @param value_ - value, moved from only if pushed
+   * @return True if pushed
+   */
+  bool TryPush(T &value_) {
+    Cell *cell;
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff = std::intptr_t(sequence) - std::intptr_t(pos);
+
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value_);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops value unless the queue is empty
+   * @param value_ - popped value
+   * @return True if popped
+   */
+  bool TryPop(T &value_) {
+    Cell *cell;
+    size_t pos = m_head.load(std::memory_order_relaxed);
+
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff = std::intptr_t(sequence) - std::intptr_t(pos + 1);
+
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+
+    value_ = std::move(cell->value);
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns capacity
+   * @return Capacity
+   */
+  size_t Capacity() const { return m_mask + 1; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  const size_t m_mask;
+  std::unique_ptr<Cell[]> m_cells;
+  alignas(64) std::atomic<size_t> m_head{};
+  alignas(64) std::atomic<size_t> m_tail{};
+};
+} // namespace cat
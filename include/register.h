@@ -1,27 +1,297 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
 
+#include "batch.h"
 #include "cat_export.h"
+#include "memo.h"
 #include "node.h"
 
 namespace cat {
 
+/**
+ * @brief Returns set type of C++ type
+ * @return Set type
+ */
+template <typename T, size_t I = 0> constexpr ESetTypes set_type() {
+  static_assert(I < std::variant_size_v<TSetValue>, "Not a set value type");
+
+  if constexpr (std::is_same_v<T, std::variant_alternative_t<I, TSetValue>>)
+    return ESetTypes(I);
+  else
+    return set_type<T, I + 1>();
+}
+
+/**
+ * @brief The Register class keeps functions of arrows. Writers are
+ * serialized and publish immutable snapshots of the register; readers take
+ * the current snapshot without locking
+ */
 class CAT_EXPORT Register {
 
 public:
+  Register();
+
+  Register(const Register &) = delete;
+  Register &operator=(const Register &) = delete;
+
+  /**
+   * @brief Returns register of the default execution context
+   * @return Register
+   */
   static Register &Inst();
 
   using TFn = std::function<TSetValue(TSetValue)>;
 
+  /**
+   * @brief Batch kernel maps column of arguments to column of results
+   * @return False if the kernel doesn't accept type of the column
+   */
+  using TBatchFn = std::function<bool(const TColumn &, TColumn &)>;
+
+  /**
+   * @brief Typed function writes result of argument without copying it
+   * @return False if the argument is of other type
+   */
+  using TInvoker = std::function<bool(const TSetValue &, TSetValue &)>;
+
+  /**
+   * @brief Asynchronous function starts computation and returns its future
+   */
+  using TAsyncFn = std::function<std::future<TSetValue>(const TSetValue &)>;
+
+  /**
+   * @brief The Signature struct describes types of typed function
+   */
+  struct Signature {
+    ESetTypes arg;
+    ESetTypes ret;
+  };
+
+  /**
+   * @brief The Entry struct holds everything registered for arrow
+   */
+  struct Entry {
+    // Function, memoized if memoization is enabled
+    TFn fn;
+    TBatchFn batch;
+    TInvoker invoker;
+    TAsyncFn async;
+    std::optional<Signature> signature;
+    std::shared_ptr<Memo> memo;
+  };
+
+  // Entries are keyed as the maps of register, by source, target and name
+  // regardless of internal arrows
+  struct KeyHasher {
+    std::size_t operator()(const Arrow &arrow_) const;
+  };
+
+  struct KeyEqual {
+    bool operator()(const Arrow &left_, const Arrow &right_) const;
+  };
+
+  using TEntries = std::unordered_map<Arrow, Entry, KeyHasher, KeyEqual>;
+  using TSnapshot = std::shared_ptr<const TEntries>;
+
   void Reg(const Arrow &arrow_, const TFn &fn_);
+
+  /**
+   * @brief Registers typed function. Types are checked along sequences when
+   * plans are compiled, the function is called on unpacked values and serves
+   * as batch kernel of arrow unless there is an explicit one
+   * @param arrow_ - arrow
+   * @param fn_ - callable taking TArg and returning TRet
+   */
+  template <typename TArg, typename TRet, typename TCallable>
+  void Reg(const Arrow &arrow_, TCallable fn_) {
+    TFn fn = [fn_](TSetValue arg_) -> TSetValue {
+      return TRet(fn_(std::get<TArg>(arg_)));
+    };
+
+    TInvoker invoker = [fn_](const TSetValue &arg_, TSetValue &ret_) {
+      auto arg = std::get_if<TArg>(&arg_);
+      if (!arg)
+        return false;
+
+      ret_ = TRet(fn_(*arg));
+      return true;
+    };
+
+    TBatchFn batch = [fn_](const TColumn &args_, TColumn &rets_) {
+      auto args = std::get_if<std::vector<TArg>>(&args_);
+      if (!args)
+        return false;
+
+      std::vector<TRet> rets(args->size());
+      for (size_t i = 0; i < rets.size(); ++i)
+        rets[i] = fn_((*args)[i]);
+      rets_ = std::move(rets);
+
+      return true;
+    };
+
+    regTyped(arrow_, std::move(fn), {set_type<TArg>(), set_type<TRet>()},
+             std::move(invoker), std::move(batch));
+  }
+
   void Unreg(const Arrow &arrow_);
-  const TFn &Get(const Arrow &arrow_);
+
+  /**
+   * @brief Returns function of arrow
+   * @param arrow_ - arrow
+   * @return Function, identity if there is no function registered
+   */
+  TFn Get(const Arrow &arrow_) const;
+
+  /**
+   * @brief Returns current snapshot of register. The snapshot doesn't change,
+   * later registrations make new ones
+   * @return Snapshot
+   */
+  TSnapshot Snapshot() const;
+
+  /**
+   * @brief Finds entry of arrow in snapshot
+   * @param snapshot_ - snapshot
+   * @param arrow_ - arrow
+   * @return Entry or nullptr if nothing is registered for arrow
+   */
+  static const Entry *Find(const TSnapshot &snapshot_, const Arrow &arrow_);
+
+  /**
+   * @brief Registers asynchronous function. Executor::RunAsync keeps other
+   * runs going while the result is pending; other executions wait for it
+   * @param arrow_ - arrow
+   * @param fn_ - function
+   */
+  void RegAsync(const Arrow &arrow_, const TAsyncFn &fn_);
+
+  /**
+   * @brief Returns asynchronous function of arrow
+   * @param arrow_ - arrow
+   * @return Function, empty if the function is not asynchronous
+   */
+  TAsyncFn GetAsync(const Arrow &arrow_) const;
+
+  /**
+   * @brief Registers batch kernel of arrow. Arrows without batch kernel are
+   * executed value by value with the registered function
+   * @param arrow_ - arrow
+   * @param fn_ - batch kernel
+   */
+  void RegBatch(const Arrow &arrow_, const TBatchFn &fn_);
+
+  /**
+   * @brief Registers typed batch kernel
+   * @param arrow_ - arrow
+   * @param kernel_ - callable taking Span<const TArg> and Span<TRet> of the
+   * same size
+   */
+  template <typename TArg, typename TRet, typename TKernel>
+  void RegBatch(const Arrow &arrow_, TKernel kernel_) {
+    RegBatch(arrow_, [kernel_](const TColumn &args_, TColumn &rets_) {
+      auto args = std::get_if<std::vector<TArg>>(&args_);
+      if (!args)
+        return false;
+
+      std::vector<TRet> rets(args->size());
+      kernel_(Span<const TArg>(*args), Span<TRet>(rets));
+      rets_ = std::move(rets);
+
+      return true;
+    });
+  }
+
+  /**
+   * @brief Returns batch kernel of arrow
+   * @param arrow_ - arrow
+   * @return Kernel, empty if there is no batch kernel
+   */
+  TBatchFn GetBatch(const Arrow &arrow_) const;
+
+  /**
+   * @brief Returns signature of typed function of arrow
+   * @param arrow_ - arrow
+   * @return Signature or nothing if the function is not typed
+   */
+  std::optional<Signature> GetSignature(const Arrow &arrow_) const;
+
+  /**
+   * @brief Returns invoker of typed function of arrow
+   * @param arrow_ - arrow
+   * @return Invoker, empty if the function is not typed
+   */
+  TInvoker GetInvoker(const Arrow &arrow_) const;
+
+  /**
+   * @brief Enables memoization of arrow function. Results are remembered by
+   * argument value, so the function has to be pure. Registration of another
+   * function of arrow drops the memo. Batch kernels are not memoized
+   * @param arrow_ - arrow
+   * @param capacity_ - maximum number of remembered results
+   * @return False if there is no function registered for arrow
+   */
+  bool Memoize(const Arrow &arrow_, size_t capacity_);
+
+  /**
+   * @brief Disables memoization of arrow function
+   * @param arrow_ - arrow
+   */
+  void Unmemoize(const Arrow &arrow_);
+
+  /**
+   * @brief Returns memo statistics of arrow
+   * @param arrow_ - arrow
+   * @return Statistics or nothing if arrow function is not memoized
+   */
+  std::optional<Memo::Stats> GetMemoStats(const Arrow &arrow_) const;
+
+  /**
+   * @brief Returns generation of register, it changes with every
+   * registration
+   * @return Generation
+   */
+  size_t Generation() const;
 
 private:
-  Register() = default;
 
+  struct Typed {
+    Signature signature;
+    TInvoker invoker;
+    TBatchFn batch;
+  };
+
+  struct Memoized {
+    std::shared_ptr<Memo> memo;
+    TFn fn;
+    TInvoker invoker;
+  };
+
+  void regTyped(const Arrow &arrow_, TFn fn_, Signature signature_,
+                TInvoker invoker_, TBatchFn batch_);
+  void reg(const Arrow &arrow_, const TFn &fn_);
+  void publish(const Arrow &arrow_);
+  const TSnapshot &snapshot() const;
+
+  // Registrations, guarded by the writer mutex
   std::map<Arrow, TFn> m_functions;
+  std::map<Arrow, TBatchFn> m_batches;
+  std::map<Arrow, Typed> m_typed;
+  std::map<Arrow, Memoized> m_memos;
+  std::map<Arrow, TAsyncFn> m_async;
+  std::mutex m_mutex;
+
+  TSnapshot m_snapshot;
+  std::atomic<size_t> m_generation;
 };
 } // namespace cat
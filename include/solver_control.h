@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+#include "cat_export.h"
+
+namespace cat {
+
+/**
+ * @brief The SolverControl class bounds exponential solvers by a wall-clock
+ * deadline, an operation budget and a cancellation flag. Solvers stop at the
+ * first exhausted limit, return partial results and mark the control as
+ * truncated
+ */
+class CAT_EXPORT SolverControl {
+public:
+  using TClock = std::chrono::steady_clock;
+
+  SolverControl() = default;
+
+  SolverControl(const SolverControl &) = delete;
+  SolverControl &operator=(const SolverControl &) = delete;
+
+  /**
+   * @brief Sets deadline relative to the current time
+   * @param timeout_ - time limit
+   */
+  void SetTimeout(TClock::duration timeout_);
+
+  /**
+   * @brief Sets deadline
+   * @param deadline_ - point in time
+   */
+  void SetDeadline(TClock::time_point deadline_);
+
+  /**
+   * @brief Sets operation budget
+   * @param operations_ - number of operations
+   */
+  void SetBudget(size_t operations_);
+
+  /**
+   * @brief Requests cancellation. Safe to call from any thread
+   */
+  void Cancel();
+
+  /**
+   * @brief Checks whether cancellation is requested
+   * @return True if cancelled
+   */
+  bool IsCancelled() const;
+
+  /**
+   * @brief Accounts operations and checks the limits
+   * @param operations_ - number of operations
+   * @return False if the solver has to stop
+   */
+  bool Step(size_t operations_ = 1);
+
+  /**
+   * @brief Checks whether a solver was stopped by the control
+   * @return True if results are partial
+   */
+  bool IsTruncated() const;
+
+  /**
+   * @brief Returns number of accounted operations
+   * @return Number of operations
+   */
+  size_t Operations() const;
+
+private:
+  std::optional<TClock::time_point> m_deadline;
+  std::optional<size_t> m_budget;
+  std::atomic<size_t> m_operations{};
+  std::atomic<bool> m_cancelled{};
+  std::atomic<bool> m_truncated{};
+};
+} // namespace cat
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cat_export.h"
+#include "memory_report.h"
+
+namespace cat {
+
+/**
+ * @brief The Tensor class is an immutable array of doubles with a shape. The
+ * buffer is reference counted and shared by copies, slices and reshapes, so
+ * passing tensors between nodes doesn't copy elements. Elements are stored
+ * contiguously in row-major order
+ */
+class CAT_EXPORT Tensor {
+public:
+  using TShape = std::vector<std::size_t>;
+
+  /**
+   * @brief Tensor constructor, empty one-dimensional tensor
+   */
+  Tensor();
+
+  /**
+   * @brief Tensor constructor, one-dimensional tensor
+   * @param data_ - elements
+   */
+  explicit Tensor(std::vector<double> data_);
+
+  /**
+   * @brief Makes tensor of shape
+   * @param data_ - elements in row-major order
+   * @param shape_ - shape
+   * @return Tensor or nothing if number of elements doesn't fit the shape
+   */
+  static std::optional<Tensor> Create(std::vector<double> data_,
+                                      TShape shape_);
+
+  const TShape &Shape() const;
+  std::size_t Rank() const;
+
+  /**
+   * @brief Returns number of elements
+   * @return Number of elements
+   */
+  std::size_t Size() const;
+
+  const double *Data() const;
+  const double *begin() const;
+  const double *end() const;
+
+  /**
+   * @brief Returns element by flat index
+   * @param index_ - index in row-major order
+   * @return Element
+   */
+  double operator[](std::size_t index_) const;
+
+  /**
+   * @brief Returns element by index along every dimension
+   * @param index_ - indices
+   * @return Element or nothing if indices are out of the shape
+   */
+  std::optional<double> At(const std::vector<std::size_t> &index_) const;
+
+  /**
+   * @brief Returns rows [begin_, end_) of the first dimension without
+   * copying elements
+   * @param begin_ - first row
+   * @param end_ - row after the last one
+   * @return Slice or nothing if rows are out of the shape
+   */
+  std::optional<Tensor> Slice(std::size_t begin_, std::size_t end_) const;
+
+  /**
+   * @brief Returns the same elements with another shape without copying
+   * @param shape_ - shape
+   * @return Tensor or nothing if number of elements differs
+   */
+  std::optional<Tensor> Reshape(TShape shape_) const;
+
+  /**
+   * @brief Applies function to every element
+   * @param fn_ - function
+   * @return New tensor of the same shape
+   */
+  Tensor Transform(const std::function<double(double)> &fn_) const;
+
+  /**
+   * @brief Copies elements
+   * @return Elements in row-major order
+   */
+  std::vector<double> ToVector() const;
+
+  /**
+   * @brief Checks if tensors share the buffer
+   * @param other_ - tensor
+   * @return True if the buffer is the same
+   */
+  bool SharesBuffer(const Tensor &other_) const;
+
+  std::size_t Hash() const;
+
+  /**
+   * @brief Adds heap bytes of the buffer to the report, the buffer shared by
+   * copies, slices and reshapes is counted once
+   * @param usage_ - report
+   * @param visited_ - shared buffers already counted
+   */
+  void MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const;
+
+  bool operator==(const Tensor &other_) const;
+  bool operator!=(const Tensor &other_) const;
+  bool operator<(const Tensor &other_) const;
+
+private:
+  Tensor(std::shared_ptr<const std::vector<double>> buffer_,
+         std::size_t offset_, TShape shape_);
+
+  static std::size_t elements(const TShape &shape_);
+
+  std::shared_ptr<const std::vector<double>> m_buffer;
+  std::size_t m_offset{};
+  TShape m_shape;
+};
+} // namespace cat
+
+namespace std {
+template <> struct hash<cat::Tensor> {
+  std::size_t operator()(const cat::Tensor &tensor_) const {
+    return tensor_.Hash();
+  }
+};
+} // namespace std
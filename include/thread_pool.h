@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cat_export.h"
+
+namespace cat {
+
+/**
+ * @brief The ThreadPool class runs tasks on a fixed set of worker threads.
+ * Every worker owns a task queue; tasks submitted from a worker go to its own
+ * queue and idle workers steal tasks from the queues of the others
+ */
+class CAT_EXPORT ThreadPool {
+public:
+  using TTask = std::function<void()>;
+
+  /**
+   * @brief ThreadPool constructor
+   * @param threads_ - number of worker threads
+   */
+  explicit ThreadPool(size_t threads_ = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Returns default thread pool
+   * @return Thread pool
+   */
+  static ThreadPool &Inst();
+
+  /**
+   * @brief Schedules task for execution
+   * @param task_ - task
+   */
+  void Submit(TTask task_);
+
+  /**
+   * @brief Runs one pending task on the calling thread. Lets threads waiting
+   * for results of submitted tasks help instead of blocking
+   * @return True if a task was run
+   */
+  bool RunPending();
+
+  /**
+   * @brief Calls function for every index in [0, count_) on the pool and the
+   * calling thread, returns once all calls are done. The first exception
+   * thrown by a call is rethrown after all calls are done
+   * @param count_ - number of indices
+   * @param fn_ - function of index
+   */
+  void ForEach(size_t count_, const std::function<void(size_t)> &fn_);
+
+  /**
+   * @brief Returns number of worker threads
+   * @return Number of threads
+   */
+  size_t Size() const;
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<TTask> tasks;
+  };
+
+  void worker(size_t index_);
+  bool take(size_t index_, TTask &task_);
+  void run(TTask &task_);
+
+  std::vector<std::thread> m_threads;
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::atomic<size_t> m_pending{};
+  std::atomic<size_t> m_next{};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop{};
+};
+} // namespace cat
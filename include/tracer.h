@@ -0,0 +1,197 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cat_export.h"
+
+namespace cat {
+
+/**
+ * @brief The Histogram class counts latencies in log-linear buckets: every
+ * power of two is split into equal sub-buckets, so the relative error of
+ * percentiles is bounded by the sub-bucket width (1/16)
+ */
+class CAT_EXPORT Histogram {
+public:
+  /**
+   * @brief Adds value
+   * @param value_ - value in nanoseconds
+   */
+  void Record(uint64_t value_);
+
+  /**
+   * @brief Adds values of another histogram
+   * @param other_ - histogram
+   */
+  void Merge(const Histogram &other_);
+
+  uint64_t Count() const;
+  uint64_t Total() const;
+  uint64_t Min() const;
+  uint64_t Max() const;
+  double Mean() const;
+
+  /**
+   * @brief Returns upper bound of the bucket holding the percentile
+   * @param percentile_ - percentile in [0, 100]
+   * @return Value, 0 if the histogram is empty
+   */
+  uint64_t Percentile(double percentile_) const;
+
+private:
+  static size_t bucket(uint64_t value_);
+  static uint64_t upper_bound(size_t bucket_);
+
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count{};
+  uint64_t m_total{};
+  uint64_t m_min{};
+  uint64_t m_max{};
+};
+
+/**
+ * @brief The Tracer class collects timings of the executor: call counts and
+ * latency histograms by category and name (arrow functions by arrow name,
+ * runs by kind of run) and, if enabled, trace events exportable in Chrome
+ * trace event format (chrome://tracing, Perfetto)
+ */
+class CAT_EXPORT Tracer {
+public:
+  enum class ECategory {
+    // Registered function of arrow applied to a value
+    eArrow,
+    // Arrow mapping internal nodes
+    eMap,
+    // Replacing node by the result of mapping
+    eReplace,
+    // Resolving functions of arrows while compiling
+    eResolve,
+    // Whole run of a plan
+    eRun
+  };
+
+  struct Stats {
+    uint64_t calls{};
+    Histogram latency;
+  };
+
+  struct Event {
+    ECategory category;
+    std::string name;
+    // Nanoseconds since creation of the tracer
+    uint64_t start;
+    uint64_t duration;
+    size_t thread;
+  };
+
+  /**
+   * @brief The Scope class measures its lifetime and records it to the
+   * tracer. Nothing is measured without tracer
+   */
+  class CAT_EXPORT Scope {
+  public:
+    /**
+     * @brief Scope constructor
+     * @param tracer_ - tracer or nullptr
+     * @param category_ - category
+     * @param name_ - name, has to outlive the scope
+     */
+    Scope(Tracer *tracer_, ECategory category_, const std::string &name_);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    Tracer *m_tracer;
+    ECategory m_category;
+    const std::string &m_name;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  Tracer();
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  /**
+   * @brief Switches collecting of trace events, statistics are collected
+   * always
+   * @param enabled_ - true to collect events
+   */
+  void EnableEvents(bool enabled_);
+
+  /**
+   * @brief Records measurement
+   * @param category_ - category
+   * @param name_ - name
+   * @param start_ - start
+   * @param end_ - end
+   */
+  void Record(ECategory category_, const std::string &name_,
+              std::chrono::steady_clock::time_point start_,
+              std::chrono::steady_clock::time_point end_);
+
+  /**
+   * @brief Returns statistics of name
+   * @param category_ - category
+   * @param name_ - name
+   * @return Statistics, empty if nothing was recorded
+   */
+  Stats GetStats(ECategory category_, const std::string &name_) const;
+
+  /**
+   * @brief Returns statistics of all names of category
+   * @param category_ - category
+   * @return Statistics by name
+   */
+  std::map<std::string, Stats> GetStats(ECategory category_) const;
+
+  /**
+   * @brief Returns collected events
+   * @return Events in order of completion
+   */
+  std::vector<Event> GetEvents() const;
+
+  /**
+   * @brief Exports events in Chrome trace event format
+   * @return JSON document
+   */
+  std::string ChromeTrace() const;
+
+  /**
+   * @brief Writes events in Chrome trace event format to file
+   * @param path_ - file path
+   * @return True if successful
+   */
+  bool WriteChromeTrace(const std::string &path_) const;
+
+  /**
+   * @brief Drops statistics and events
+   */
+  void Reset();
+
+  /**
+   * @brief Returns name of category
+   * @param category_ - category
+   * @return Name
+   */
+  static const char *CategoryName(ECategory category_);
+
+private:
+  size_t thread_index(std::thread::id id_);
+
+  std::chrono::steady_clock::time_point m_epoch;
+  bool m_events{};
+  std::map<std::pair<ECategory, std::string>, Stats> m_stats;
+  std::vector<Event> m_log;
+  std::map<std::thread::id, size_t> m_threads;
+  mutable std::mutex m_mutex;
+};
+} // namespace cat
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "cat_export.h"
+#include "node.h"
+
+namespace cat {
+
+struct Plan;
+
+/**
+ * @brief The ValueStore class keeps values of objects of a plan apart from
+ * the node, indexed by plan slot. Executors read and write values in place,
+ * so several of them can run one node (which is not changed) with their own
+ * stores
+ */
+class CAT_EXPORT ValueStore {
+public:
+  ValueStore() = default;
+
+  /**
+   * @brief ValueStore constructor
+   * @param size_ - number of slots
+   */
+  explicit ValueStore(size_t size_);
+
+  /**
+   * @brief Takes current values of slots of the plan from the node
+   * @param plan_ - plan
+   * @param node_ - node the plan was compiled for
+   * @return Store or nothing if a slot has no node
+   */
+  static std::optional<ValueStore> Load(const Plan &plan_, const Node &node_);
+
+  /**
+   * @brief Writes values of slots written by the plan to the node
+   * @param plan_ - plan
+   * @param node_ - node the plan was compiled for
+   */
+  void Store(const Plan &plan_, Node &node_) const;
+
+  /**
+   * @brief Writes values in binary form
+   * @param out_ - stream
+   * @return True if successful
+   */
+  bool Write(std::ostream &out_) const;
+
+  /**
+   * @brief Reads values written by Write
+   * @param in_ - stream
+   * @return Store or nothing if the data is malformed
+   */
+  static std::optional<ValueStore> Read(std::istream &in_);
+
+  size_t Size() const;
+
+  /**
+   * @brief Returns value of slot
+   * @param slot_ - slot
+   * @return Value
+   */
+  const TSetValue &Get(size_t slot_) const;
+
+  /**
+   * @brief Sets value of slot
+   * @param slot_ - slot
+   * @param value_ - value
+   */
+  void Set(size_t slot_, TSetValue value_);
+
+  /**
+   * @brief Returns value of node
+   * @param plan_ - plan the store belongs to
+   * @param name_ - node name
+   * @return Value or nothing if the node isn't in the plan
+   */
+  std::optional<TSetValue> Find(const Plan &plan_,
+                                const Node::NName &name_) const;
+
+  /**
+   * @brief Returns values of all slots
+   * @return Values
+   */
+  std::vector<TSetValue> &Values();
+  const std::vector<TSetValue> &Values() const;
+
+  /**
+   * @brief Returns hash of values of plan inputs i.e. slots no hop writes
+   * @param plan_ - plan the store belongs to
+   * @return Hash value
+   */
+  std::size_t InputHash(const Plan &plan_) const;
+
+private:
+  std::vector<TSetValue> m_values;
+};
+} // namespace cat
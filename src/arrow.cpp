@@ -5,8 +5,11 @@
 #include <cstring>
 #include <fstream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stack>
+#include <unordered_map>
 
 #include "node.h"
 #include "parser.h"
@@ -43,25 +46,32 @@ bool Arrow::operator<(const Arrow &arrow_) const {
 
 //-----------------------------------------------------------------------------------------
 bool Arrow::operator==(const Arrow &arrow_) const {
+  if (Hash() != arrow_.Hash())
+    return false;
+
   return m_source == arrow_.m_source && m_target == arrow_.m_target &&
-         m_name == arrow_.m_name && m_arrows == arrow_.m_arrows;
+         m_name == arrow_.m_name &&
+         (m_arrows == arrow_.m_arrows || arrows() == arrow_.arrows());
 }
 
 //-----------------------------------------------------------------------------------------
-bool Arrow::operator!=(const Arrow &arrow_) const {
-  return m_source != arrow_.m_source || m_target != arrow_.m_target ||
-         m_name != arrow_.m_name || m_arrows != arrow_.m_arrows;
-}
+bool Arrow::operator!=(const Arrow &arrow_) const { return !(*this == arrow_); }
 
 //-----------------------------------------------------------------------------------------
 std::optional<Node> Arrow::Map(const std::optional<Node> &node_) const {
+  return Map(node_, Register::Inst());
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Node> Arrow::Map(const std::optional<Node> &node_,
+                               const Register &register_) const {
   if (!node_.has_value() || node_->Name() != m_source) {
     return {};
   }
 
   Node ret(m_target, node_->Type());
 
-  const Register::TFn &fn = Register::Inst().Get(*this);
+  const Register::TFn &fn = register_.Get(*this);
   ret.SetValue(fn(node_->GetValue()));
 
   // Mapping of nodes
@@ -111,7 +121,10 @@ std::string Arrow::IdArrowName(const std::string &name_) {
 }
 
 //-----------------------------------------------------------------------------------------
-void Arrow::SetDefaultName() { m_name = DefaultArrowName(m_source, m_target); }
+void Arrow::SetDefaultName() {
+  m_name = DefaultArrowName(m_source, m_target);
+  resetHash();
+}
 
 //-----------------------------------------------------------------------------------------
 const std::string &Arrow::Source() const { return m_source; }
@@ -123,6 +136,8 @@ void Arrow::SetSource(const std::string &source_) {
     m_name = DefaultArrowName(m_source, m_target);
   } else
     m_source = source_;
+
+  resetHash();
 }
 
 //-----------------------------------------------------------------------------------------
@@ -135,40 +150,55 @@ void Arrow::SetTarget(const std::string &target_) {
     m_name = DefaultArrowName(m_source, m_target);
   } else
     m_target = target_;
+
+  resetHash();
 }
 
 //-----------------------------------------------------------------------------------------
 const Arrow::AName &Arrow::Name() const { return m_name; }
 
 //-----------------------------------------------------------------------------------------
-void Arrow::AddArrow(const Arrow &arrow_) { m_arrows.push_back(arrow_); }
+void Arrow::AddArrow(const Arrow &arrow_) {
+  mutableArrows().push_back(arrow_);
+  resetHash();
+}
 
 //-----------------------------------------------------------------------------------------
 void Arrow::EraseArrow(const Arrow::AName &arrow_) {
-  auto it = std::find_if(m_arrows.begin(), m_arrows.end(),
-                         [&](const List::value_type &element_) {
-                           return element_.Name() == arrow_;
-                         });
+  auto fnMatch = [&](const List::value_type &element_) {
+    return element_.Name() == arrow_;
+  };
+
+  if (std::none_of(arrows().begin(), arrows().end(), fnMatch))
+    return;
+
+  List &list = mutableArrows();
+  list.erase(std::find_if(list.begin(), list.end(), fnMatch));
 
-  if (it != m_arrows.end())
-    m_arrows.erase(it);
+  resetHash();
 }
 
 //-----------------------------------------------------------------------------------------
-void Arrow::EraseArrows() { m_arrows.clear(); }
+void Arrow::EraseArrows() {
+  m_arrows.reset();
+  m_interned = false;
+  resetHash();
+}
 
 //-----------------------------------------------------------------------------------------
 Arrow::List Arrow::QueryArrows(const std::string &query_,
                                std::optional<size_t> matchCount_) const {
-  return Parser::QueryArrows(query_, m_arrows, matchCount_);
+  return Parser::QueryArrows(query_, arrows(), matchCount_);
 }
 
 //-----------------------------------------------------------------------------------------
-bool Arrow::IsEmpty() const { return m_arrows.empty(); }
+bool Arrow::IsEmpty() const { return arrows().empty(); }
 
 //-----------------------------------------------------------------------------------------
 std::optional<Node> Arrow::singleMapImpl(const std::string &name_) const {
-  for (const Arrow &arrow : m_arrows) {
+  for (const Arrow &arrow : arrows()) {
+    count_operation(ECounter::eArrowScans);
+
     if (arrow.Source() == name_) {
       return Node(arrow.Target(), Node::EType::eObject);
     }
@@ -195,14 +225,19 @@ void Arrow::Inverse() {
 
   std::swap(m_source, m_target);
 
-  for (auto &arrow : m_arrows)
-    arrow.Inverse();
+  if (!arrows().empty()) {
+    for (auto &arrow : mutableArrows())
+      arrow.Inverse();
+  }
+
+  resetHash();
 }
 
 //-----------------------------------------------------------------------------------------
 bool Arrow::IsInvertible() const {
-  for (auto it = m_arrows.begin(); it != m_arrows.end(); ++it) {
-    for (auto it_match = it; it_match != m_arrows.end(); ++it_match) {
+  const List &list = arrows();
+  for (auto it = list.begin(); it != list.end(); ++it) {
+    for (auto it_match = it; it_match != list.end(); ++it_match) {
       if (it == it_match) {
         continue;
       }
@@ -230,15 +265,19 @@ bool Arrow::IsAssociative(const Arrow &arrow) const {
   if (arrow.CountArrows() != CountArrows())
     return false;
 
-  for (auto &right : arrow.QueryArrows(Arrow("*", "*").AsQuery())) {
-    auto result =
-        QueryArrows(Arrow(right.Source(), right.Target(), "*").AsQuery());
-    if (result.empty())
-      return false;
+  if (arrow.mappingHash() != mappingHash())
+    return false;
+
+  std::unordered_multimap<std::size_t, const Arrow *> lefts;
+  for (const Arrow &left : arrows())
+    lefts.emplace(left.mappingHash(), &left);
+
+  for (const Arrow &right : arrow.arrows()) {
+    auto [begin, end] = lefts.equal_range(right.mappingHash());
 
     bool isFound{};
-    for (auto &left : result) {
-      if (left.IsAssociative(right)) {
+    for (auto it = begin; it != end; ++it) {
+      if (it->second->IsAssociative(right)) {
         isFound = true;
         break;
       }
@@ -252,12 +291,13 @@ bool Arrow::IsAssociative(const Arrow &arrow) const {
 }
 
 //-----------------------------------------------------------------------------------------
-size_t Arrow::CountArrows() const { return m_arrows.size(); }
+size_t Arrow::CountArrows() const { return arrows().size(); }
 
 //-----------------------------------------------------------------------------------------
 bool Arrow::IsValid() const {
-  for (auto it = m_arrows.begin(); it != m_arrows.end(); ++it) {
-    for (auto it_match = it; it_match != m_arrows.end(); ++it_match) {
+  const List &list = arrows();
+  for (auto it = list.begin(); it != list.end(); ++it) {
+    for (auto it_match = it; it_match != list.end(); ++it_match) {
       if (it == it_match) {
         continue;
       }
@@ -303,3 +343,175 @@ std::optional<Arrow> Arrow::Compose(const Arrow &arrow_) const {
 
   return ret.empty() ? std::optional<Arrow>() : ret.front();
 }
+
+//-----------------------------------------------------------------------------------------
+std::size_t Arrow::Hash() const {
+  return m_hash.Get([this]() {
+    std::size_t seed = std::hash<std::string>{}(m_source);
+    hash_combine(seed, std::hash<std::string>{}(m_target));
+    hash_combine(seed, std::hash<std::string>{}(m_name));
+
+    for (const Arrow &arrow : arrows())
+      hash_combine(seed, arrow.Hash());
+
+    return seed;
+  });
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t Arrow::mappingHash() const {
+  return m_mappingHash.Get([this]() {
+    std::size_t seed = std::hash<std::string>{}(m_source);
+    hash_combine(seed, std::hash<std::string>{}(m_target));
+
+    // Sum keeps the hash independent of the order of internal arrows
+    std::size_t internal{};
+    for (const Arrow &arrow : arrows())
+      internal += hash_mix(arrow.mappingHash());
+
+    hash_combine(seed, internal);
+
+    return seed;
+  });
+}
+
+//-----------------------------------------------------------------------------------------
+void Arrow::resetHash() {
+  m_hash.Reset();
+  m_mappingHash.Reset();
+}
+
+//-----------------------------------------------------------------------------------------
+//-----------------------------------------------------------------------------------------
+std::size_t ArrowKeyHasher::operator()(const Arrow &arrow_) const {
+  return arrow_.Hash();
+}
+
+//-----------------------------------------------------------------------------------------
+//-----------------------------------------------------------------------------------------
+namespace {
+// Pool of interned internal mappings. Entries are removed by the deleter of
+// the last owner, the pool itself is never destroyed so that arrows with
+// static storage duration can outlive it safely
+struct MappingPool {
+  std::mutex mutex;
+  std::unordered_multimap<std::size_t, std::pair<const Arrow::List *,
+                                                 std::weak_ptr<Arrow::List>>>
+      entries;
+};
+
+MappingPool &mapping_pool() {
+  static MappingPool *pool = new MappingPool;
+  return *pool;
+}
+
+void release_mapping(std::size_t hash_, const Arrow::List *list_) {
+  MappingPool &pool = mapping_pool();
+
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    auto [begin, end] = pool.entries.equal_range(hash_);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second.first == list_) {
+        pool.entries.erase(it);
+        break;
+      }
+    }
+  }
+
+  delete list_;
+}
+
+std::size_t list_hash(const Arrow::List &list_) {
+  std::size_t seed{};
+  for (const Arrow &arrow : list_)
+    hash_combine(seed, arrow.Hash());
+
+  return seed;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+const Arrow::List &Arrow::arrows() const {
+  static const List empty;
+  return m_arrows ? *m_arrows : empty;
+}
+
+//-----------------------------------------------------------------------------------------
+Arrow::List &Arrow::mutableArrows() {
+  if (!m_arrows)
+    m_arrows = std::make_shared<List>();
+  else if (m_interned || m_arrows.use_count() > 1)
+    m_arrows = std::make_shared<List>(*m_arrows);
+
+  m_interned = false;
+
+  return *m_arrows;
+}
+
+//-----------------------------------------------------------------------------------------
+void Arrow::Intern() {
+  if (m_interned || !m_arrows)
+    return;
+
+  // Nested mappings are shared as well
+  for (Arrow &arrow : mutableArrows())
+    arrow.Intern();
+
+  std::size_t hash = list_hash(*m_arrows);
+
+  MappingPool &pool = mapping_pool();
+
+  // Released after unlocking the pool, since they may be the last owners of
+  // pooled mappings and releasing them locks the pool
+  std::shared_ptr<List> previous = m_arrows;
+  std::vector<std::shared_ptr<List>> rejected;
+
+  std::lock_guard<std::mutex> lock(pool.mutex);
+
+  auto [begin, end] = pool.entries.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    auto shared = it->second.second.lock();
+    if (shared && *shared == *m_arrows) {
+      m_arrows = std::move(shared);
+      m_interned = true;
+      return;
+    }
+
+    if (shared)
+      rejected.push_back(std::move(shared));
+  }
+
+  auto shared = std::shared_ptr<List>(
+      new List(std::move(*m_arrows)),
+      [hash](const List *list_) { release_mapping(hash, list_); });
+
+  pool.entries.emplace(hash, std::make_pair(shared.get(), shared));
+
+  m_arrows = std::move(shared);
+  m_interned = true;
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Arrow::CountInterned() {
+  MappingPool &pool = mapping_pool();
+
+  std::lock_guard<std::mutex> lock(pool.mutex);
+
+  return pool.entries.size();
+}
+
+//-----------------------------------------------------------------------------------------
+void Arrow::MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const {
+  usage_.names += heap_size(m_source) + heap_size(m_target) + heap_size(m_name);
+
+  if (!m_arrows || !visited_.insert(m_arrows.get()).second)
+    return;
+
+  usage_.mappings += heap_shared_size(sizeof(List));
+  for (const Arrow &arrow : *m_arrows) {
+    usage_.mappings += heap_node_size(sizeof(Arrow), 2);
+    arrow.MemoryReport(usage_, visited_);
+  }
+}
@@ -0,0 +1,53 @@
+#include "batch.h"
+
+#include <type_traits>
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+std::size_t cat::column_size(const TColumn &column_) {
+  return std::visit([](const auto &values_) { return values_.size(); },
+                    column_);
+}
+
+//-----------------------------------------------------------------------------------------
+TSetValue cat::column_value(const TColumn &column_, std::size_t index_) {
+  return std::visit(
+      [&](const auto &values_) { return TSetValue(values_[index_]); },
+      column_);
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<TColumn>
+cat::make_column(const std::vector<TSetValue> &values_) {
+  if (values_.empty())
+    return TColumn();
+
+  return std::visit(
+      [&](const auto &first_) -> std::optional<TColumn> {
+        using T = std::decay_t<decltype(first_)>;
+
+        std::vector<T> ret;
+        ret.reserve(values_.size());
+
+        for (const auto &value : values_) {
+          if (!std::holds_alternative<T>(value))
+            return {};
+
+          ret.push_back(std::get<T>(value));
+        }
+
+        return TColumn(std::move(ret));
+      },
+      values_.front());
+}
+
+//-----------------------------------------------------------------------------------------
+TColumn cat::make_column(const TSetValue &value_, std::size_t size_) {
+  return std::visit(
+      [&](const auto &first_) -> TColumn {
+        using T = std::decay_t<decltype(first_)>;
+        return std::vector<T>(size_, first_);
+      },
+      value_);
+}
@@ -0,0 +1,105 @@
+#include "checkpoint.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "log.h"
+
+using namespace cat;
+
+namespace {
+// File starts with magic, format version and byte order mark
+constexpr char magic[8] = {'C', 'A', 'T', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t version = 1;
+constexpr uint32_t byte_order = 0x01020304;
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+Checkpoint::Checkpoint(size_t hash_, size_t cursor_, ValueStore store_)
+    : m_hash(hash_), m_cursor(cursor_), m_store(std::move(store_)) {}
+
+//-----------------------------------------------------------------------------------------
+bool Checkpoint::Save(const std::string &path_, size_t hash_, size_t cursor_,
+                      const ValueStore &store_) {
+  const std::string temp = path_ + ".tmp";
+
+  {
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      print_error("Can't open file " + temp);
+      return false;
+    }
+
+    const uint64_t hash = hash_;
+    const uint64_t cursor = cursor_;
+
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char *>(&byte_order),
+               sizeof(byte_order));
+    file.write(reinterpret_cast<const char *>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char *>(&cursor), sizeof(cursor));
+
+    if (!store_.Write(file) || !file.flush()) {
+      print_error("Can't write checkpoint " + temp);
+      return false;
+    }
+  }
+
+  if (std::rename(temp.c_str(), path_.c_str()) != 0) {
+    print_error("Can't replace checkpoint " + path_);
+    std::remove(temp.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Checkpoint> Checkpoint::Load(const std::string &path_) {
+  std::ifstream file(path_, std::ios::binary);
+  if (!file)
+    return {};
+
+  char fileMagic[sizeof(magic)];
+  uint32_t fileVersion;
+  uint32_t fileByteOrder;
+  uint64_t hash;
+  uint64_t cursor;
+
+  file.read(fileMagic, sizeof(fileMagic));
+  file.read(reinterpret_cast<char *>(&fileVersion), sizeof(fileVersion));
+  file.read(reinterpret_cast<char *>(&fileByteOrder), sizeof(fileByteOrder));
+  file.read(reinterpret_cast<char *>(&hash), sizeof(hash));
+  file.read(reinterpret_cast<char *>(&cursor), sizeof(cursor));
+
+  if (!file || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+      fileVersion != version || fileByteOrder != byte_order) {
+    print_error("File " + path_ + " is not a checkpoint");
+    return {};
+  }
+
+  auto store = ValueStore::Read(file);
+  if (!store.has_value()) {
+    print_error("Checkpoint " + path_ + " is malformed");
+    return {};
+  }
+
+  return Checkpoint(hash, cursor, std::move(store.value()));
+}
+
+//-----------------------------------------------------------------------------------------
+void Checkpoint::Remove(const std::string &path_) {
+  std::remove(path_.c_str());
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Checkpoint::Hash() const { return m_hash; }
+
+//-----------------------------------------------------------------------------------------
+size_t Checkpoint::Cursor() const { return m_cursor; }
+
+//-----------------------------------------------------------------------------------------
+ValueStore &Checkpoint::Store() { return m_store; }
@@ -0,0 +1,53 @@
+#include "counters.h"
+
+#include <atomic>
+#include <cstddef>
+
+using namespace cat;
+
+namespace {
+std::atomic<uint64_t> g_counters[size_t(ECounter::eCount)]{};
+std::atomic<TAllocationHook> g_allocation_hook{nullptr};
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+void cat::set_counting(bool enabled_) {
+  detail::g_counting.store(enabled_, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+bool cat::get_counting() {
+  return detail::g_counting.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+void cat::add_operation(ECounter counter_, uint64_t count_) {
+  g_counters[size_t(counter_)].fetch_add(count_, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+uint64_t cat::get_counter(ECounter counter_) {
+  return g_counters[size_t(counter_)].load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+void cat::reset_counters() {
+  for (auto &counter : g_counters)
+    counter.store(0, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+void cat::set_allocation_hook(TAllocationHook hook_) {
+  g_allocation_hook.store(hook_, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+void cat::count_allocation(std::size_t bytes_, bool allocated_) {
+  if (allocated_) {
+    count_operation(ECounter::eAllocations);
+    count_operation(ECounter::eAllocatedBytes, bytes_);
+  }
+
+  if (auto hook = g_allocation_hook.load(std::memory_order_relaxed))
+    hook(bytes_, allocated_);
+}
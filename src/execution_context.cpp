@@ -0,0 +1,61 @@
+#include "execution_context.h"
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+ExecutionContext::ExecutionContext(size_t threads_)
+    : m_ownRegister(std::make_unique<Register>()),
+      m_ownPool(std::make_unique<ThreadPool>(threads_)),
+      m_ownExecutor(std::make_unique<Executor>(*m_ownRegister)),
+      m_register(*m_ownRegister), m_pool(*m_ownPool),
+      m_executor(*m_ownExecutor) {}
+
+//-----------------------------------------------------------------------------------------
+ExecutionContext::ExecutionContext(Register &register_, ThreadPool &pool_,
+                                   Executor &executor_)
+    : m_register(register_), m_pool(pool_), m_executor(executor_) {}
+
+//-----------------------------------------------------------------------------------------
+ExecutionContext &ExecutionContext::Default() {
+  static ExecutionContext context(Register::Inst(), ThreadPool::Inst(),
+                                  Executor::Inst());
+  return context;
+}
+
+//-----------------------------------------------------------------------------------------
+Register &ExecutionContext::GetRegister() const { return m_register; }
+
+//-----------------------------------------------------------------------------------------
+ThreadPool &ExecutionContext::GetPool() const { return m_pool; }
+
+//-----------------------------------------------------------------------------------------
+Executor &ExecutionContext::GetExecutor() const { return m_executor; }
+
+//-----------------------------------------------------------------------------------------
+bool ExecutionContext::Exec(Node &node_) {
+  return count(m_executor.Exec(node_));
+}
+
+//-----------------------------------------------------------------------------------------
+bool ExecutionContext::ExecParallel(Node &node_) {
+  return count(m_executor.Exec(node_, m_pool));
+}
+
+//-----------------------------------------------------------------------------------------
+bool ExecutionContext::ExecHierarchy(Node &node_) {
+  return count(m_executor.ExecHierarchy(node_, m_pool));
+}
+
+//-----------------------------------------------------------------------------------------
+auto ExecutionContext::GetStats() const -> Stats {
+  return {m_execs.load(), m_failures.load()};
+}
+
+//-----------------------------------------------------------------------------------------
+bool ExecutionContext::count(bool ok_) {
+  ++m_execs;
+  if (!ok_)
+    ++m_failures;
+
+  return ok_;
+}
@@ -1,17 +1,247 @@
 #include "node.h"
 
+#include "checkpoint.h"
 #include "executor.h"
+#include "log.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 
 using namespace cat;
 
+namespace {
+// Names of runs recorded by tracer
+const std::string run_serial = "serial";
+const std::string run_parallel = "parallel";
+const std::string run_incremental = "incremental";
+const std::string run_store = "store";
+const std::string run_checkpointed = "checkpointed";
+const std::string run_hierarchy = "hierarchy";
+const std::string run_batch = "batch";
+const std::string run_async = "async";
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+std::optional<size_t> Plan::Slot(const Node::NName &name_) const {
+  auto it = std::find(slots.begin(), slots.end(), name_);
+  if (it == slots.end())
+    return {};
+
+  return std::distance(slots.begin(), it);
+}
+
+//-----------------------------------------------------------------------------------------
+bool Plan::Apply(const Hop &hop_, std::vector<TSetValue> &values_) const {
+  if (!hop_.invoker) {
+    values_[hop_.target] = hop_.fn(values_[hop_.source]);
+    return true;
+  }
+
+  if (!hop_.invoker(values_[hop_.source], values_[hop_.target])) {
+    print_error("Arrow " + hop_.arrow.Name() + " doesn't accept type of " +
+                slots[hop_.source]);
+    return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Plan::Hash() const {
+  size_t ret = slots.size();
+  for (const auto &name : slots)
+    hash_combine(ret, std::hash<std::string>{}(name));
+
+  for (const auto &hop : hops) {
+    hash_combine(ret, hop.source);
+    hash_combine(ret, hop.target);
+    hash_combine(ret, hop.arrow.Hash());
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+Executor::Executor(Register &register_) : m_register(register_) {}
+
 //-----------------------------------------------------------------------------------------
 Executor &Executor::Inst() {
-  static Executor reg;
+  static Executor reg(Register::Inst());
   return reg;
 }
 
+//-----------------------------------------------------------------------------------------
+Register &Executor::GetRegister() const { return m_register; }
+
+//-----------------------------------------------------------------------------------------
+void Executor::SetTracer(Tracer *tracer_) { m_tracer = tracer_; }
+
+//-----------------------------------------------------------------------------------------
+Tracer *Executor::GetTracer() const { return m_tracer; }
+
 //-----------------------------------------------------------------------------------------
 bool Executor::Exec(Node &node_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_cacheCapacity == 0) {
+    auto plan = Compile(node_);
+    return plan.has_value() && Run(plan.value(), node_);
+  }
+
+  const size_t hash = node_.Hash();
+
+  // Nodes of equal hashes are told apart by structure
+  auto [begin, end] = m_cacheIndex.equal_range(hash);
+  auto it = std::find_if(begin, end, [&](const auto &entry_) {
+    return entry_.second->structure.SameStructure(node_);
+  });
+
+  if (it == end) {
+    while (m_cache.size() >= m_cacheCapacity)
+      evict_plan();
+
+    m_cache.push_front(
+        {node_, hash, m_register.Generation(), Compile(node_), {}});
+    it = m_cacheIndex.emplace(hash, m_cache.begin());
+  } else {
+    m_cache.splice(m_cache.begin(), m_cache, it->second);
+  }
+
+  Cached &cached = *it->second;
+  if (cached.generation != m_register.Generation()) {
+    cached.generation = m_register.Generation();
+    cached.plan = Compile(node_);
+    cached.versions.clear();
+  }
+
+  if (!cached.plan.has_value())
+    return false;
+
+  return Run(cached.plan.value(), node_, cached.versions);
+}
+
+//-----------------------------------------------------------------------------------------
+void Executor::ResetCache() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cacheIndex.clear();
+  m_cache.clear();
+}
+
+//-----------------------------------------------------------------------------------------
+void Executor::SetCacheCapacity(size_t capacity_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_cacheCapacity = capacity_;
+  while (m_cache.size() > m_cacheCapacity)
+    evict_plan();
+}
+
+//-----------------------------------------------------------------------------------------
+void Executor::evict_plan() {
+  auto last = std::prev(m_cache.end());
+
+  auto [begin, end] = m_cacheIndex.equal_range(last->hash);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second == last) {
+      m_cacheIndex.erase(it);
+      break;
+    }
+  }
+
+  m_cache.pop_back();
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Exec(Node &node_, ThreadPool &pool_) {
+  auto plan = Compile(node_);
+  if (!plan.has_value())
+    return false;
+
+  return Run(plan.value(), node_, pool_);
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::ExecHierarchy(Node &node_, ThreadPool &pool_) {
+  Tracer::Scope scope(m_tracer, Tracer::ECategory::eRun, run_hierarchy);
+
+  // Hops of the plan are functors between internal categories
+  auto plan = Compile(node_);
+  if (!plan.has_value())
+    return false;
+
+  Register::TSnapshot functions = m_register.Snapshot();
+
+  std::vector<bool> executed(plan->slots.size());
+  auto fnExec = [&](size_t slot_) {
+    bool ok{true};
+    node_.UpdateNode(plan->slots[slot_], [&](Node &category_) {
+      if (!category_.IsNodesEmpty())
+        ok = Exec(category_);
+    });
+
+    executed[slot_] = true;
+    return ok;
+  };
+
+  for (const auto &hop : plan->hops) {
+    if (!executed[hop.source] && !fnExec(hop.source))
+      return false;
+
+    if (!map_functor(node_, plan.value(), hop, functions, pool_))
+      return false;
+
+    executed[hop.target] = false;
+  }
+
+  for (size_t slot = 0; slot < plan->slots.size(); ++slot) {
+    if (!executed[slot] && !fnExec(slot))
+      return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Plan> Executor::Compile(const Node &node_) const {
+  Plan plan;
+
+  // Functions are taken from one snapshot of the register
+  Register::TSnapshot functions = m_register.Snapshot();
+
+  Tracer *tracer = m_tracer;
+
+  // Types of slot values, unknown after untyped functions. Slots which are
+  // not written yet are unknown as well, the plan is reused for other values
+  // and typed functions check them when the plan runs
+  std::vector<std::optional<ESetTypes>> types;
+
+  std::map<Node::NName, size_t> slots;
+  auto fnSlot = [&](const Node &node_) {
+    auto [it, inserted] = slots.emplace(node_.Name(), plan.slots.size());
+    if (inserted) {
+      plan.slots.push_back(node_.Name());
+      types.emplace_back();
+    }
+    return it->second;
+  };
+
+  // Slots holding internal nodes produced by mapping
+  std::vector<bool> structural;
+
+  // Chains sharing a prefix would repeat its hops. A hop is emitted again
+  // only if its source or target was written by another hop since then
+  std::vector<std::optional<size_t>> lastWriter;
+  std::map<std::pair<size_t, size_t>,
+           std::pair<std::optional<size_t>, std::optional<size_t>>>
+      emitted;
+
   Node::List beginNodes = node_.Initial();
   Node::List endNodes = node_.Terminal();
 
@@ -20,35 +250,807 @@ bool Executor::Exec(Node &node_) {
       std::list<Node::NName> nodeChain =
           node_.SolveSequence(begin.Name(), end.Name());
 
+      if (nodeChain.size() < 2)
+        continue;
+
       auto itEnd = std::prev(nodeChain.end());
       for (auto it = nodeChain.begin(); it != itEnd; ++it) {
-        auto sourceList = node_.QueryNodes(*(std::next(it, 0)));
-        if (sourceList.empty()) {
-          return false;
+        const Node *source = node_.FindNode(*it);
+        if (!source) {
+          return {};
         }
-        const auto &source = sourceList.front();
 
-        auto targetList = node_.QueryNodes(*(std::next(it, 1)));
-        if (targetList.empty()) {
-          return false;
+        const Node *target = node_.FindNode(*std::next(it));
+        if (!target) {
+          return {};
         }
-        auto &target = targetList.front();
 
         auto arrow = node_.QueryArrows(
-            Arrow(source.Name(), target.Name(), "*").AsQuery());
+            Arrow(source->Name(), target->Name(), "*").AsQuery());
         if (arrow.empty()) {
-          return false;
+          return {};
         }
 
-        auto mapTarget = arrow.front().Map(source);
-        if (!mapTarget.has_value()) {
-          return false;
+        size_t sourceSlot = fnSlot(*source);
+        size_t targetSlot = fnSlot(*target);
+
+        lastWriter.resize(plan.slots.size());
+
+        auto key = std::make_pair(sourceSlot, targetSlot);
+        auto itEmitted = emitted.find(key);
+        if (itEmitted != emitted.end() &&
+            itEmitted->second ==
+                std::make_pair(lastWriter[sourceSlot], lastWriter[targetSlot]))
+          continue;
+
+        Register::Entry entry;
+        {
+          Tracer::Scope scope(tracer, Tracer::ECategory::eResolve,
+                              arrow.front().Name());
+
+          const Register::Entry *found =
+              Register::Find(functions, arrow.front());
+          if (found)
+            entry = *found;
+
+          // Unregistered arrow is identity, as "Register::Get" returns it
+          if (!entry.fn)
+            entry.fn = [](TSetValue arg_) { return arg_; };
+        }
+
+        const auto &signature = entry.signature;
+        if (signature && types[sourceSlot] &&
+            types[sourceSlot] != signature->arg) {
+          print_error("Arrow " + arrow.front().Name() +
+                      " doesn't accept type of " + source->Name());
+          return {};
+        }
+
+        types[targetSlot] = signature
+                                ? std::optional<ESetTypes>(signature->ret)
+                                : std::nullopt;
+
+        structural.resize(plan.slots.size());
+
+        bool isStructural = !source->IsNodesEmpty() ||
+                            !target->IsNodesEmpty() || structural[sourceSlot];
+        structural[targetSlot] = structural[targetSlot] || isStructural;
+
+        plan.hops.push_back({sourceSlot, targetSlot, arrow.front(),
+                             std::move(entry.fn), isStructural,
+                             std::move(entry.batch), std::move(entry.invoker),
+                             std::move(entry.async)});
+
+        emitted[key] = {lastWriter[sourceSlot], plan.hops.size() - 1};
+        lastWriter[targetSlot] = plan.hops.size() - 1;
+      }
+    }
+  }
+
+  return plan;
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Plan>
+Executor::Compile(const Node &node_,
+                  const std::vector<Node::NName> &outputs_) const {
+  auto plan = Compile(node_);
+  if (!plan.has_value())
+    return {};
+
+  return Fuse(plan.value(), outputs_);
+}
+
+//-----------------------------------------------------------------------------------------
+Plan Executor::Fuse(const Plan &plan_,
+                    const std::vector<Node::NName> &outputs_) const {
+  std::vector<size_t> reads(plan_.slots.size());
+  std::vector<size_t> writes(plan_.slots.size());
+  for (const auto &hop : plan_.hops) {
+    ++reads[hop.source];
+    ++writes[hop.target];
+  }
+
+  std::vector<bool> kept(plan_.slots.size());
+  for (const auto &name : outputs_) {
+    if (auto slot = plan_.Slot(name))
+      kept[slot.value()] = true;
+  }
+
+  Plan ret;
+  ret.slots = plan_.slots;
+
+  for (const auto &hop : plan_.hops) {
+    if (!ret.hops.empty()) {
+      Plan::Hop &prev = ret.hops.back();
+
+      bool fusable = !prev.structural && !hop.structural && !prev.async &&
+                     !hop.async &&
+                     prev.target == hop.source && !kept[hop.source] &&
+                     reads[hop.source] == 1 && writes[hop.source] == 1;
+
+      if (fusable) {
+        prev = fuse_hops(ret, prev, hop);
+        continue;
+      }
+    }
+
+    ret.hops.push_back(hop);
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Run(const Plan &plan_, Node &node_) const {
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_serial);
+
+  std::vector<TSetValue> values;
+  if (!load_values(plan_, node_, values))
+    return false;
+
+  for (const auto &hop : plan_.hops) {
+    if (!run_hop(plan_, hop, node_, values, m_register, tracer))
+      return false;
+  }
+
+  store_values(plan_, node_, values);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Run(const Plan &plan_, Node &node_, ThreadPool &pool_) const {
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_parallel);
+
+  std::vector<TSetValue> values;
+  if (!load_values(plan_, node_, values))
+    return false;
+
+  const size_t count = plan_.hops.size();
+  if (count == 0)
+    return true;
+
+  // Hop waits for earlier hops writing its source or reading and writing its
+  // target, so the result is the same as of the serial run. Hops mapping
+  // internal nodes change the node itself and are ordered among themselves
+  std::vector<std::vector<size_t>> dependents(count);
+  std::vector<size_t> waiting(count);
+
+  std::vector<std::optional<size_t>> lastWriter(plan_.slots.size());
+  std::vector<std::vector<size_t>> readers(plan_.slots.size());
+  std::optional<size_t> lastStructural;
+
+  for (size_t i = 0; i < count; ++i) {
+    const Plan::Hop &hop = plan_.hops[i];
+
+    std::vector<size_t> deps = readers[hop.target];
+    if (lastWriter[hop.source])
+      deps.push_back(lastWriter[hop.source].value());
+    if (lastWriter[hop.target])
+      deps.push_back(lastWriter[hop.target].value());
+    if (hop.structural && lastStructural)
+      deps.push_back(lastStructural.value());
+
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+    for (size_t dep : deps) {
+      if (dep != i)
+        dependents[dep].push_back(i);
+    }
+    waiting[i] = deps.size() - std::count(deps.begin(), deps.end(), i);
+
+    readers[hop.source].push_back(i);
+    readers[hop.target].clear();
+    lastWriter[hop.target] = i;
+    if (hop.structural)
+      lastStructural = i;
+  }
+
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t remaining;
+    size_t completed{};
+    bool failed{};
+    std::function<void(size_t)> schedule;
+  };
+
+  auto state = std::make_shared<State>();
+  state->remaining = count;
+
+  // Scheduling lives in the shared state, the tasks may outlive this frame.
+  // It holds the state weakly, otherwise the state would never be released
+  std::weak_ptr<State> weak = state;
+  state->schedule = [&, weak](size_t index_) {
+    std::shared_ptr<State> state = weak.lock();
+    pool_.Submit([&, state, index_]() {
+      bool failed;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        failed = state->failed;
+      }
+
+      // After a failure the rest of hops are only drained. Exception fails the
+      // run, the counters are updated anyway so the caller doesn't wait forever
+      bool ok = failed;
+      if (!failed) {
+        const Plan::Hop &hop = plan_.hops[index_];
+        try {
+          ok = run_hop(plan_, hop, node_, values, m_register, tracer);
+        } catch (const std::exception &e_) {
+          print_error("Arrow " + hop.arrow.Name() + " failed: " + e_.what());
+        } catch (...) {
+          print_error("Arrow " + hop.arrow.Name() + " failed");
+        }
+      }
+
+      std::vector<size_t> ready;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->failed = state->failed || !ok;
+        for (size_t dependent : dependents[index_]) {
+          if (--waiting[dependent] == 0)
+            ready.push_back(dependent);
+        }
+        --state->remaining;
+        ++state->completed;
+      }
+
+      for (size_t dependent : ready)
+        state->schedule(dependent);
+
+      state->cv.notify_all();
+    });
+  };
+
+  // Roots are collected first, finished hops update the counters
+  std::vector<size_t> roots;
+  for (size_t i = 0; i < count; ++i) {
+    if (waiting[i] == 0)
+      roots.push_back(i);
+  }
+
+  for (size_t root : roots)
+    state->schedule(root);
+
+  // Calling thread helps with pending tasks while waiting
+  size_t seen{};
+  while (true) {
+    if (pool_.RunPending())
+      continue;
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (state->remaining == 0)
+      break;
+
+    state->cv.wait(lock, [&]() {
+      return state->remaining == 0 || state->completed != seen;
+    });
+    seen = state->completed;
+  }
+
+  if (state->failed)
+    return false;
+
+  store_values(plan_, node_, values);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Run(const Plan &plan_, Node &node_, TVersions &versions_) const {
+  std::vector<size_t> writes(plan_.slots.size());
+  bool incremental = versions_.size() == plan_.slots.size();
+
+  for (const auto &hop : plan_.hops) {
+    incremental = incremental && !hop.structural && ++writes[hop.target] == 1;
+  }
+
+  if (!incremental) {
+    versions_.clear();
+    if (!Run(plan_, node_))
+      return false;
+
+    load_versions(plan_, node_, versions_);
+    return true;
+  }
+
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_incremental);
+
+  std::vector<TSetValue> values;
+  if (!load_values(plan_, node_, values))
+    return false;
+
+  TVersions current;
+  load_versions(plan_, node_, current);
+
+  std::vector<bool> dirty(plan_.slots.size());
+  for (size_t slot = 0; slot < plan_.slots.size(); ++slot)
+    dirty[slot] = current[slot] != versions_[slot];
+
+  for (const auto &hop : plan_.hops) {
+    if (!dirty[hop.source] && !dirty[hop.target])
+      continue;
+
+    TSetValue previous = values[hop.target];
+    if (!run_hop(plan_, hop, node_, values, m_register, tracer)) {
+      versions_.clear();
+      return false;
+    }
+
+    // Unchanged results stop propagation
+    if (values[hop.target] != previous) {
+      dirty[hop.target] = true;
+      node_.SetNodeValue(plan_.slots[hop.target], values[hop.target]);
+    }
+  }
+
+  load_versions(plan_, node_, versions_);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Run(const Plan &plan_, ValueStore &store_) const {
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_store);
+
+  if (store_.Size() != plan_.slots.size()) {
+    print_error("Value store doesn't match the plan");
+    return false;
+  }
+
+  for (const auto &hop : plan_.hops) {
+    if (hop.structural) {
+      print_error("Run of arrow " + hop.arrow.Name() +
+                  " mapping internal nodes over value store");
+      return false;
+    }
+  }
+
+  for (const auto &hop : plan_.hops) {
+    Tracer::Scope hopScope(tracer, Tracer::ECategory::eArrow,
+                           hop.arrow.Name());
+
+    if (!plan_.Apply(hop, store_.Values()))
+      return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::Run(const Plan &plan_, Node &node_, const std::string &path_,
+                   size_t interval_) const {
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_checkpointed);
+
+  for (const auto &hop : plan_.hops) {
+    if (hop.structural) {
+      print_error("Checkpointed run of arrow " + hop.arrow.Name() +
+                  " mapping internal nodes");
+      return false;
+    }
+  }
+
+  std::optional<ValueStore> store = ValueStore::Load(plan_, node_);
+  if (!store.has_value())
+    return false;
+
+  // Checkpoint belongs to the node, the plan and the input values
+  size_t hash = node_.Hash();
+  hash_combine(hash, plan_.Hash());
+  hash_combine(hash, store->InputHash(plan_));
+
+  size_t cursor{};
+
+  if (auto checkpoint = Checkpoint::Load(path_)) {
+    if (checkpoint->Hash() == hash &&
+        checkpoint->Cursor() <= plan_.hops.size() &&
+        checkpoint->Store().Size() == plan_.slots.size()) {
+      cursor = checkpoint->Cursor();
+      store = std::move(checkpoint->Store());
+    } else {
+      print_info("Checkpoint " + path_ + " is of another run, ignored");
+    }
+  }
+
+  interval_ = std::max<size_t>(interval_, 1);
+
+  // Failed run keeps the last checkpoint to be resumed from
+  while (cursor < plan_.hops.size()) {
+    const Plan::Hop &hop = plan_.hops[cursor];
+    {
+      Tracer::Scope hopScope(tracer, Tracer::ECategory::eArrow,
+                             hop.arrow.Name());
+
+      if (!plan_.Apply(hop, store->Values()))
+        return false;
+    }
+
+    ++cursor;
+    if (cursor % interval_ == 0 && cursor < plan_.hops.size() &&
+        !Checkpoint::Save(path_, hash, cursor, store.value())) {
+      print_error("Checkpointed run stopped, progress can't be saved to " +
+                  path_);
+      return false;
+    }
+  }
+
+  store->Store(plan_, node_);
+  Checkpoint::Remove(path_);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+auto Executor::RunBatch(const Plan &plan_, const Node &node_,
+                        const TBatch &inputs_) const -> std::optional<TBatch> {
+  Tracer *tracer = m_tracer;
+  Tracer::Scope scope(tracer, Tracer::ECategory::eRun, run_batch);
+
+  for (const auto &hop : plan_.hops) {
+    if (hop.structural) {
+      print_error("Batch run of arrow " + hop.arrow.Name() +
+                  " mapping internal nodes");
+      return {};
+    }
+  }
+
+  std::optional<size_t> size;
+  for (const auto &[name, column] : inputs_) {
+    if (size && size != column_size(column)) {
+      print_error("Input column " + name + " differs in size");
+      return {};
+    }
+
+    size = column_size(column);
+  }
+
+  std::vector<TColumn> columns;
+  columns.reserve(plan_.slots.size());
+
+  for (const auto &name : plan_.slots) {
+    auto it = inputs_.find(name);
+    if (it != inputs_.end()) {
+      columns.push_back(it->second);
+      continue;
+    }
+
+    const Node *node = node_.FindNode(name);
+    if (!node) {
+      return {};
+    }
+
+    columns.push_back(make_column(node->GetValue(), size.value_or(0)));
+  }
+
+  std::vector<TSetValue> values;
+  for (const auto &hop : plan_.hops) {
+    Tracer::Scope hopScope(tracer, Tracer::ECategory::eArrow,
+                           hop.arrow.Name());
+
+    const TColumn &source = columns[hop.source];
+
+    TColumn target;
+    if (hop.batch && hop.batch(source, target)) {
+      columns[hop.target] = std::move(target);
+      continue;
+    }
+
+    values.resize(column_size(source));
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (!hop.invoker) {
+        values[i] = hop.fn(column_value(source, i));
+      } else if (!hop.invoker(column_value(source, i), values[i])) {
+        print_error("Arrow " + hop.arrow.Name() + " doesn't accept type of " +
+                    plan_.slots[hop.source]);
+        return {};
+      }
+    }
+
+    auto column = make_column(values);
+    if (!column.has_value()) {
+      print_error("Results of arrow " + hop.arrow.Name() + " differ in type");
+      return {};
+    }
+
+    columns[hop.target] = std::move(column.value());
+  }
+
+  TBatch ret;
+  for (size_t slot = 0; slot < plan_.slots.size(); ++slot)
+    ret.emplace(plan_.slots[slot], std::move(columns[slot]));
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+std::vector<std::optional<Executor::TRecord>>
+Executor::RunAsync(const Plan &plan_, std::vector<TRecord> records_,
+                   size_t inFlight_) const {
+  Tracer::Scope scope(m_tracer, Tracer::ECategory::eRun, run_async);
+
+  std::vector<std::optional<TRecord>> ret(records_.size());
+
+  for (const auto &hop : plan_.hops) {
+    if (hop.structural) {
+      print_error("Asynchronous run of arrow " + hop.arrow.Name() +
+                  " mapping internal nodes");
+      return ret;
+    }
+  }
+
+  struct Flight {
+    size_t record;
+    size_t hop;
+    std::future<TSetValue> pending;
+  };
+
+  // Runs synchronous hops up to the next asynchronous one and starts it
+  auto fnAdvance = [&](Flight &flight_) {
+    TRecord &record = records_[flight_.record];
+    if (record.size() != plan_.slots.size())
+      return true;
+
+    for (; flight_.hop < plan_.hops.size(); ++flight_.hop) {
+      const Plan::Hop &hop = plan_.hops[flight_.hop];
+
+      // Failure of function fails only the record
+      try {
+        if (hop.async) {
+          flight_.pending = hop.async(record[hop.source]);
+          if (flight_.pending.valid())
+            return false;
+
+          print_error("Arrow " + hop.arrow.Name() + " gave no result");
+          return true;
         }
 
-        node_.ReplaceNode(mapTarget.value());
+        if (!plan_.Apply(hop, record))
+          return true;
+      } catch (const std::exception &e_) {
+        print_error("Arrow " + hop.arrow.Name() + " failed: " + e_.what());
+        return true;
+      } catch (...) {
+        print_error("Arrow " + hop.arrow.Name() + " failed");
+        return true;
+      }
+    }
+
+    ret[flight_.record] = std::move(record);
+    return true;
+  };
+
+  // Takes result of asynchronous function and continues
+  auto fnComplete = [&](Flight &flight_) {
+    const Plan::Hop &hop = plan_.hops[flight_.hop];
+
+    try {
+      records_[flight_.record][hop.target] = flight_.pending.get();
+    } catch (const std::exception &e_) {
+      print_error("Arrow " + hop.arrow.Name() + " failed: " + e_.what());
+      return true;
+    } catch (...) {
+      print_error("Arrow " + hop.arrow.Name() + " failed");
+      return true;
+    }
+
+    ++flight_.hop;
+    return fnAdvance(flight_);
+  };
+
+  inFlight_ = std::max<size_t>(inFlight_, 1);
+
+  std::list<Flight> flights;
+  size_t next{};
+
+  while (next < records_.size() || !flights.empty()) {
+    while (flights.size() < inFlight_ && next < records_.size()) {
+      flights.push_back({next++, 0, {}});
+      if (fnAdvance(flights.back()))
+        flights.pop_back();
+    }
+
+    bool progress{};
+    for (auto it = flights.begin(); it != flights.end();) {
+      if (it->pending.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+        ++it;
+        continue;
       }
+
+      progress = true;
+      it = fnComplete(*it) ? flights.erase(it) : std::next(it);
+    }
+
+    if (!progress && !flights.empty())
+      flights.front().pending.wait_for(std::chrono::microseconds(100));
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::load_values(const Plan &plan_, const Node &node_,
+                           std::vector<TSetValue> &values_) {
+  auto store = ValueStore::Load(plan_, node_);
+  if (!store.has_value())
+    return false;
+
+  values_ = std::move(store->Values());
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::run_hop(const Plan &plan_, const Plan::Hop &hop_, Node &node_,
+                       std::vector<TSetValue> &values_,
+                       const Register &register_, Tracer *tracer_) {
+  if (!hop_.structural) {
+    Tracer::Scope scope(tracer_, Tracer::ECategory::eArrow, hop_.arrow.Name());
+    return plan_.Apply(hop_, values_);
+  }
+
+  Node source = *node_.FindNode(plan_.slots[hop_.source]);
+  source.SetValue(values_[hop_.source]);
+
+  std::optional<Node> mapTarget;
+  {
+    Tracer::Scope scope(tracer_, Tracer::ECategory::eMap, hop_.arrow.Name());
+    mapTarget = hop_.arrow.Map(source, register_);
+  }
+
+  if (!mapTarget.has_value()) {
+    return false;
+  }
+
+  values_[hop_.target] = mapTarget->GetValue();
+
+  Tracer::Scope scope(tracer_, Tracer::ECategory::eReplace,
+                      plan_.slots[hop_.target]);
+  node_.ReplaceNode(mapTarget.value());
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+void Executor::store_values(const Plan &plan_, Node &node_,
+                            std::vector<TSetValue> &values_) {
+  std::vector<bool> written(plan_.slots.size());
+  for (const auto &hop : plan_.hops)
+    written[hop.target] = true;
+
+  for (size_t slot = 0; slot < plan_.slots.size(); ++slot) {
+    if (written[slot])
+      node_.SetNodeValue(plan_.slots[slot], std::move(values_[slot]));
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+Plan::Hop Executor::fuse_hops(const Plan &plan_, const Plan::Hop &first_,
+                              const Plan::Hop &second_) {
+  Plan::Hop ret{first_.source, second_.target,
+                Arrow(plan_.slots[first_.source], plan_.slots[second_.target],
+                      first_.arrow.Name() + "." + second_.arrow.Name()),
+                {}, false};
+
+  ret.fn = [first = first_.fn, second = second_.fn](TSetValue arg_) {
+    return second(first(std::move(arg_)));
+  };
+
+  // Typed and untyped functions are combined through invokers
+  auto fnInvoker = [](const Plan::Hop &hop_) -> Register::TInvoker {
+    if (hop_.invoker)
+      return hop_.invoker;
+
+    return [fn = hop_.fn](const TSetValue &arg_, TSetValue &ret_) {
+      ret_ = fn(arg_);
+      return true;
+    };
+  };
+
+  if (first_.invoker || second_.invoker) {
+    ret.invoker = [first = fnInvoker(first_), second = fnInvoker(second_)](
+                      const TSetValue &arg_, TSetValue &ret_) {
+      TSetValue value;
+      return first(arg_, value) && second(value, ret_);
+    };
+  }
+
+  if (first_.batch && second_.batch) {
+    ret.batch = [first = first_.batch, second = second_.batch](
+                    const TColumn &args_, TColumn &rets_) {
+      TColumn column;
+      return first(args_, column) && second(column, rets_);
+    };
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Executor::map_functor(Node &node_, const Plan &plan_,
+                           const Plan::Hop &hop_,
+                           const Register::TSnapshot &functions_,
+                           ThreadPool &pool_) const {
+  const Node *source = node_.FindNode(plan_.slots[hop_.source]);
+  const Node *target = node_.FindNode(plan_.slots[hop_.target]);
+  if (!source || !target) {
+    return false;
+  }
+
+  struct Mapping {
+    const Arrow *arrow;
+    const TSetValue *arg;
+    Register::TFn fn;
+    TSetValue ret;
+  };
+
+  const Arrow::List &arrows =
+      hop_.arrow.QueryArrows(Arrow("*", "*").AsQuery());
+
+  std::vector<Mapping> mappings;
+  mappings.reserve(arrows.size());
+
+  for (const auto &arrow : arrows) {
+    const Node *object = source->FindNode(arrow.Source());
+    if (!object || !target->FindNode(arrow.Target())) {
+      print_error("Functor " + hop_.arrow.Name() + " maps " + arrow.Source() +
+                  " to " + arrow.Target() + " which are not objects");
+      return false;
     }
+
+    const Register::Entry *entry = Register::Find(functions_, arrow);
+    mappings.push_back({&arrow, &object->GetValue(),
+                        entry && entry->fn ? entry->fn : hop_.fn, {}});
   }
 
+  Tracer *tracer = m_tracer;
+  std::atomic<bool> failed{};
+
+  // Objects are independent, their values are mapped in parallel
+  pool_.ForEach(mappings.size(), [&](size_t index_) {
+    Mapping &mapping = mappings[index_];
+    Tracer::Scope scope(tracer, Tracer::ECategory::eArrow,
+                        mapping.arrow->Name());
+    try {
+      mapping.ret = mapping.fn(*mapping.arg);
+    } catch (const std::exception &e_) {
+      print_error("Arrow " + mapping.arrow->Name() + " failed: " + e_.what());
+      failed = true;
+    } catch (...) {
+      print_error("Arrow " + mapping.arrow->Name() + " failed");
+      failed = true;
+    }
+  });
+
+  if (failed)
+    return false;
+
+  TSetValue value = hop_.fn(source->GetValue());
+
+  node_.UpdateNode(plan_.slots[hop_.target], [&](Node &category_) {
+    category_.SetValue(std::move(value));
+    for (auto &mapping : mappings)
+      category_.SetNodeValue(mapping.arrow->Target(), std::move(mapping.ret));
+  });
+
   return true;
 }
+
+//-----------------------------------------------------------------------------------------
+void Executor::load_versions(const Plan &plan_, const Node &node_,
+                             TVersions &versions_) {
+  versions_.resize(plan_.slots.size());
+
+  for (size_t slot = 0; slot < plan_.slots.size(); ++slot) {
+    const Node *node = node_.FindNode(plan_.slots[slot]);
+    versions_[slot] = node ? node->Version() : 0;
+  }
+}
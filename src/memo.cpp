@@ -0,0 +1,74 @@
+#include "memo.h"
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+double Memo::Stats::HitRate() const {
+  size_t lookups = hits + misses;
+  return lookups ? double(hits) / lookups : 0.0;
+}
+
+//-----------------------------------------------------------------------------------------
+Memo::Memo(size_t capacity_) : m_capacity(capacity_) {}
+
+//-----------------------------------------------------------------------------------------
+std::optional<TSetValue> Memo::Find(const TSetValue &arg_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto it = m_index.find(arg_);
+  if (it == m_index.end()) {
+    ++m_stats.misses;
+    return {};
+  }
+
+  ++m_stats.hits;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+  return it->second->second;
+}
+
+//-----------------------------------------------------------------------------------------
+void Memo::Insert(const TSetValue &arg_, const TSetValue &ret_) {
+  // Arguments like NaN are not equal to themselves, they can't be found and
+  // their entries couldn't be evicted by key
+  if (m_capacity == 0 || !(arg_ == arg_))
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Concurrent callers may compute the same result
+  auto it = m_index.find(arg_);
+  if (it != m_index.end()) {
+    it->second->second = ret_;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  if (m_entries.size() == m_capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+    ++m_stats.evictions;
+  }
+
+  m_entries.emplace_front(arg_, ret_);
+  m_index.emplace(arg_, m_entries.begin());
+}
+
+//-----------------------------------------------------------------------------------------
+Memo::Stats Memo::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  Stats ret = m_stats;
+  ret.size = m_entries.size();
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+void Memo::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_entries.clear();
+  m_index.clear();
+  m_stats = Stats();
+}
@@ -0,0 +1,44 @@
+#include "memory_report.h"
+
+#include <atomic>
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+std::size_t MemoryUsage::Total() const {
+  return nodes + arrows + mappings + names + values;
+}
+
+//-----------------------------------------------------------------------------------------
+MemoryUsage &MemoryUsage::operator+=(const MemoryUsage &other_) {
+  nodes += other_.nodes;
+  arrows += other_.arrows;
+  mappings += other_.mappings;
+  names += other_.names;
+  values += other_.values;
+
+  return *this;
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t cat::heap_size(const std::string &string_) {
+  // Capacity of empty string is the small buffer
+  static const std::size_t local = std::string().capacity();
+
+  return string_.capacity() > local ? string_.capacity() + 1 : 0;
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t cat::heap_node_size(std::size_t value_, std::size_t links_) {
+  // Tree nodes keep color besides the links
+  std::size_t header =
+      links_ * sizeof(void *) + (links_ > 2 ? sizeof(void *) : 0);
+
+  return header + value_;
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t cat::heap_shared_size(std::size_t value_) {
+  // Virtual table and two reference counters
+  return sizeof(void *) + 2 * sizeof(std::atomic<int>) + value_;
+}
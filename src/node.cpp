@@ -2,14 +2,23 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stack>
 
+#include "counters.h"
 #include "parser.h"
 #include "register.h"
+#include "solver_control.h"
+#include "thread_pool.h"
 
 using namespace cat;
 
@@ -61,7 +70,10 @@ Node::EType Node::Str2Type(const std::string &type_) {
 }
 
 //-----------------------------------------------------------------------------------------
-bool Node::operator<(const Node &cat_) const { return m_name < cat_.m_name; }
+bool Node::operator<(const Node &cat_) const {
+  count_operation(ECounter::eComparisons);
+  return m_name < cat_.m_name;
+}
 
 //-----------------------------------------------------------------------------------------
 bool Node::operator==(const Node &cat_) const {
@@ -86,6 +98,7 @@ bool Node::AddArrow(const Arrow &arrow_) {
     return false;
   }
 
+  count_operation(ECounter::eArrowScans, m_arrows.size());
   for (const Arrow &arrow : m_arrows) {
     if (arrow_.Name() == arrow.Name() && arrow_.Target() != arrow.Target()) {
       print_error("Arrow redefinition: " + arrow_.Name());
@@ -103,6 +116,9 @@ bool Node::AddArrow(const Arrow &arrow_) {
   m_nodes.at(Node(arrow_.Source(), InternalNode())).insert(target);
 
   m_arrows.push_back(arrow_);
+  m_arrows.back().Intern();
+
+  m_hash.Reset();
 
   return true;
 }
@@ -148,6 +164,8 @@ bool Node::EraseArrow(const Arrow::AName &name_) {
 
   m_arrows.erase(it_delete);
 
+  m_hash.Reset();
+
   return true;
 }
 
@@ -164,6 +182,8 @@ void Node::EraseArrows() {
     nodeset.clear();
     nodeset.insert(node);
   }
+
+  m_hash.Reset();
 }
 
 //-----------------------------------------------------------------------------------------
@@ -180,6 +200,8 @@ bool Node::AddNode(const Node &node_) {
   if (m_nodes.find(node_) == m_nodes.end()) {
     m_nodes[node_];
 
+    m_hash.Reset();
+
     Arrow func(node_, node_, Arrow::IdArrowName(node_.Name()));
 
     for (const auto &id : node_.QueryNodes("*"))
@@ -225,6 +247,8 @@ bool Node::EraseNode(const NName &node_) {
 
     m_arrows.erase(it_end, m_arrows.end());
 
+    m_hash.Reset();
+
     return true;
   }
 
@@ -244,14 +268,56 @@ void Node::ReplaceNode(const Node &node_) {
     m_nodes.erase(it);
 
     m_nodes[node_] = codomain;
+
+    m_hash.Reset();
   } else
     AddNode(node_);
 }
 
+//-----------------------------------------------------------------------------------------
+const Node *Node::FindNode(const NName &name_) const {
+  auto it = m_nodes.find(Node(name_, InternalNode()));
+  return it != m_nodes.end() ? &it->first : nullptr;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Node::SetNodeValue(const NName &name_, TSetValue value_) {
+  auto it = m_nodes.find(Node(name_, InternalNode()));
+  if (it == m_nodes.end())
+    return false;
+
+  // Values do not take part in ordering, the key is updated without
+  // reallocation of the map entry
+  auto hint = std::next(it);
+  auto handle = m_nodes.extract(it);
+  handle.key().SetValue(std::move(value_));
+  m_nodes.insert(hint, std::move(handle));
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Node::UpdateNode(const NName &name_,
+                      const std::function<void(Node &)> &fn_) {
+  auto it = m_nodes.find(Node(name_, InternalNode()));
+  if (it == m_nodes.end())
+    return false;
+
+  auto hint = std::next(it);
+  auto handle = m_nodes.extract(it);
+  fn_(handle.key());
+  m_nodes.insert(hint, std::move(handle));
+
+  m_hash.Reset();
+
+  return true;
+}
+
 //-----------------------------------------------------------------------------------------
 void Node::EraseNodes() {
   m_nodes.clear();
   m_arrows.clear();
+  m_hash.Reset();
 }
 
 //-----------------------------------------------------------------------------------------
@@ -556,6 +622,9 @@ bool Node::Verify(const Arrow &arrow_) const {
   using TSource2Arrow = std::set<std::pair<Node::NName, Arrow::AName>>;
   TSource2Arrow visited;
 
+  // Mapping of objects, the first arrow of a source maps it as in SingleMap
+  std::map<Node::NName, Node::NName> mapping;
+
   for (const Arrow &arrow : arrow_.QueryArrows(Arrow("*", "*").AsQuery())) {
     auto head = TSource2Arrow::value_type(arrow.Source(), arrow.Name());
 
@@ -569,6 +638,7 @@ bool Node::Verify(const Arrow &arrow_) const {
     }
 
     visited.insert(head);
+    mapping.emplace(arrow.Source(), arrow.Target());
 
     if (InternalNode() != EType::eObject) {
       if (source_cat.QueryNodes(arrow.Source()).empty()) {
@@ -581,21 +651,34 @@ bool Node::Verify(const Arrow &arrow_) const {
 
   std::string sAny(1, ASTERISK::id);
 
+  auto fnMap = [&](const Node::NName &name_) -> std::optional<Node> {
+    auto it = mapping.find(name_);
+    if (it == mapping.end())
+      return {};
+
+    return Node(it->second, Node::EType::eObject);
+  };
+
   // Checking mapping
   for (const auto &obj : source_cat.QueryNodes(sAny)) {
-    if (!arrow_.SingleMap(obj)) {
+    if (!fnMap(obj.Name())) {
       print_error("Failure to map " + Node::Type2Name(obj.Type()) + ": " +
                   obj.Name());
       return false;
     }
   }
 
+  // Morphisms of target, scanned once instead of per arrow of source
+  std::set<std::pair<Node::NName, Node::NName>> morphisms;
+  for (const Arrow &arrow : target_cat.QueryArrows(Arrow("*", "*").AsQuery()))
+    morphisms.emplace(arrow.Source(), arrow.Target());
+
   for (const Arrow &arrow : source_cat.QueryArrows(Arrow("*", "*").AsQuery())) {
     auto mapped_source = Node(arrow.Source(), source_cat.InternalNode());
     auto mapped_target = Node(arrow.Target(), source_cat.InternalNode());
 
-    auto objs = arrow_.SingleMap(mapped_source);
-    auto objt = arrow_.SingleMap(mapped_target);
+    auto objs = fnMap(mapped_source.Name());
+    auto objt = fnMap(mapped_target.Name());
 
     if (!objs) {
       print_error("Failure to map " + Node::Type2Name(mapped_source.Type()) +
@@ -638,8 +721,7 @@ bool Node::Verify(const Arrow &arrow_) const {
     }
 
     // Checking mapping of arrows
-    if (target_cat.QueryArrows(Arrow(objs->Name(), objt->Name(), "*").AsQuery())
-            .empty()) {
+    if (!morphisms.count({objs->Name(), objt->Name()})) {
       print_error("Failure to match morphism: " + objs->Name() + " to " +
                   objt->Name());
       return false;
@@ -650,7 +732,10 @@ bool Node::Verify(const Arrow &arrow_) const {
 }
 
 //-----------------------------------------------------------------------------------------
-void Node::SetName(const NName &name_) { m_name = name_; }
+void Node::SetName(const NName &name_) {
+  m_name = name_;
+  m_hash.Reset();
+}
 
 //-----------------------------------------------------------------------------------------
 const Node::NName &Node::Name() const { return m_name; }
@@ -805,7 +890,8 @@ Node::SolveSequence(const Node::NName &from_, const Node::NName &to_,
 //-----------------------------------------------------------------------------------------
 std::list<std::list<Node::NName>>
 Node::SolveSequences(const Node::NName &from_, const Node::NName &to_,
-                     std::optional<size_t> length_) const {
+                     std::optional<size_t> length_,
+                     SolverControl *control_) const {
   std::list<std::list<Node::NName>> ret;
 
   std::list<Node::PairSet> stack;
@@ -813,6 +899,9 @@ Node::SolveSequences(const Node::NName &from_, const Node::NName &to_,
   std::optional<Node::NName> current_node(from_);
 
   while (true) {
+    if (control_ && !control_->Step())
+      return ret;
+
     // Checking for destination
     if (current_node.value() == to_) {
       std::list<Node::NName> seq;
@@ -902,9 +991,52 @@ void Node::Inverse() {
   }
 }
 
+//-----------------------------------------------------------------------------------------
+static bool for_each_candidate(const Node &source_, const Node &target_,
+                               SolverControl *control_,
+                               const std::function<bool(const Arrow &)> &fn_) {
+  Node::List source_nodes = source_.QueryNodes("*");
+  Node::List target_query = target_.QueryNodes("*");
+
+  const std::vector<Node> target_nodes(target_query.begin(),
+                                       target_query.end());
+
+  if (target_nodes.empty() && !source_nodes.empty())
+    return true;
+
+  // Odometer over target nodes, the first source node changes fastest
+  std::vector<size_t> digits(source_nodes.size(), 0);
+
+  while (true) {
+    if (control_ && !control_->Step())
+      return false;
+
+    Arrow arrow(source_, target_);
+
+    auto digit = digits.begin();
+    for (const Node &node : source_nodes)
+      arrow.AddArrow(Arrow(node.Name(), target_nodes[*digit++].Name()));
+
+    if (!fn_(arrow))
+      return false;
+
+    size_t i{};
+    for (; i < digits.size(); ++i) {
+      if (++digits[i] < target_nodes.size())
+        break;
+
+      digits[i] = 0;
+    }
+
+    if (i == digits.size())
+      return true;
+  }
+}
+
 //-----------------------------------------------------------------------------------------
 Arrow::List Node::ProposeArrows(const Node::NName &from_,
-                                const Node::NName &to_) {
+                                const Node::NName &to_,
+                                SolverControl *control_) {
   Node::List source_list = QueryNodes(from_);
   if (source_list.size() != 1)
     return Arrow::List();
@@ -915,40 +1047,191 @@ Arrow::List Node::ProposeArrows(const Node::NName &from_,
     return Arrow::List();
   const Node &target = target_list.front();
 
-  std::list<std::list<std::pair<Node, Node>>> projections;
+  Arrow::List ret;
+  for_each_candidate(source, target, control_, [&](const Arrow &arrow_) {
+    ret.push_back(arrow_);
+    return true;
+  });
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+using TDomains = std::vector<std::vector<size_t>>;
+using TAssignment = std::vector<size_t>;
+
+static const size_t sUnassigned = std::numeric_limits<size_t>::max();
+
+//-----------------------------------------------------------------------------------------
+static bool search_functors(const std::vector<std::vector<bool>> &hom_,
+                            const TDomains &out_, const TDomains &in_,
+                            const TDomains &domains_, TAssignment &assignment_,
+                            std::list<TAssignment> &solutions_,
+                            std::optional<size_t> matchCount_) {
+  // Picking the most constrained unassigned object. Limited search picks the
+  // last one instead, so solutions come in the order of "ProposeArrows" and
+  // the first found are the first valid proposals
+  size_t var = sUnassigned;
+  for (size_t i = 0; i < assignment_.size(); ++i) {
+    if (assignment_[i] != sUnassigned)
+      continue;
+
+    if (var == sUnassigned || matchCount_ ||
+        domains_[i].size() < domains_[var].size() ||
+        (domains_[i].size() == domains_[var].size() &&
+         out_[i].size() + in_[i].size() > out_[var].size() + in_[var].size()))
+      var = i;
+  }
 
-  Node::List source_nodes = source.QueryNodes("*");
-  Node::List target_nodes = target.QueryNodes("*");
+  if (var == sUnassigned) {
+    solutions_.push_back(assignment_);
+    return !matchCount_ || solutions_.size() < matchCount_.value();
+  }
 
-  projections.emplace_back(std::list<std::pair<Node, Node>>());
+  for (size_t value : domains_[var]) {
+    TDomains domains = domains_;
 
-  for (const Node &src_node : source_nodes) {
-    std::list<std::pair<Node, Node>> options;
-    for (const Node &trg_node : target_nodes) {
-      options.emplace_back(src_node, trg_node);
+    // Forward checking of the arrows adjacent to the object
+    bool consistent{true};
+    for (size_t succ : out_[var]) {
+      if (assignment_[succ] != sUnassigned || succ == var)
+        continue;
+
+      auto &domain = domains[succ];
+      domain.erase(std::remove_if(domain.begin(), domain.end(),
+                                  [&](size_t u_) { return !hom_[value][u_]; }),
+                   domain.end());
+
+      if (domain.empty()) {
+        consistent = false;
+        break;
+      }
     }
 
-    std::list<std::list<std::pair<Node, Node>>> update;
+    for (size_t pred : in_[var]) {
+      if (!consistent)
+        break;
 
-    for (auto &option : options) {
-      for (auto &projection : projections) {
-        update.emplace_back(std::list<std::pair<Node, Node>>());
-        update.back().insert(update.back().begin(), projection.begin(),
-                             projection.end());
-        update.back().push_back(option);
+      if (assignment_[pred] != sUnassigned || pred == var)
+        continue;
+
+      auto &domain = domains[pred];
+      domain.erase(std::remove_if(domain.begin(), domain.end(),
+                                  [&](size_t u_) { return !hom_[u_][value]; }),
+                   domain.end());
+
+      if (domain.empty())
+        consistent = false;
+    }
+
+    if (!consistent)
+      continue;
+
+    assignment_[var] = value;
+
+    bool proceed = search_functors(hom_, out_, in_, domains, assignment_,
+                                   solutions_, matchCount_);
+
+    assignment_[var] = sUnassigned;
+
+    if (!proceed)
+      return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+Arrow::List Node::FindFunctors(const Node::NName &from_, const Node::NName &to_,
+                               std::optional<size_t> matchCount_) const {
+  if (matchCount_ && matchCount_ == 0)
+    return Arrow::List();
+
+  Node::List source_list = QueryNodes(from_);
+  if (source_list.size() != 1)
+    return Arrow::List();
+  const Node &source = source_list.front();
+
+  Node::List target_list = QueryNodes(to_);
+  if (target_list.size() != 1)
+    return Arrow::List();
+  const Node &target = target_list.front();
+
+  std::vector<Node> source_nodes;
+  for (const auto &node : source.QueryNodes("*"))
+    source_nodes.push_back(node);
+
+  std::vector<Node> target_nodes;
+  for (const auto &node : target.QueryNodes("*"))
+    target_nodes.push_back(node);
+
+  std::map<Node::NName, size_t> source_ids;
+  for (size_t i = 0; i < source_nodes.size(); ++i)
+    source_ids[source_nodes[i].Name()] = i;
+
+  std::map<Node::NName, size_t> target_ids;
+  for (size_t i = 0; i < target_nodes.size(); ++i)
+    target_ids[target_nodes[i].Name()] = i;
+
+  // Hom-sets of the target
+  std::vector<std::vector<bool>> hom(
+      target_nodes.size(), std::vector<bool>(target_nodes.size(), false));
+
+  for (const Arrow &arrow : target.QueryArrows(Arrow("*", "*").AsQuery()))
+    hom[target_ids.at(arrow.Source())][target_ids.at(arrow.Target())] = true;
+
+  // Arrows of the source to be preserved
+  TDomains out(source_nodes.size());
+  TDomains in(source_nodes.size());
+  std::vector<bool> loops(source_nodes.size(), false);
+
+  // Nodes of objects carry no mapping constraints, see "Verify"
+  if (Type() != EType::eSet && Type() != EType::eObject) {
+    std::set<std::pair<size_t, size_t>> constraints;
+    for (const Arrow &arrow : source.QueryArrows(Arrow("*", "*").AsQuery()))
+      constraints.emplace(source_ids.at(arrow.Source()),
+                          source_ids.at(arrow.Target()));
+
+    for (const auto &[from, to] : constraints) {
+      if (from == to) {
+        loops[from] = true;
+        continue;
       }
+
+      out[from].push_back(to);
+      in[to].push_back(from);
+    }
+  }
+
+  TDomains domains(source_nodes.size());
+  for (size_t i = 0; i < source_nodes.size(); ++i) {
+    for (size_t t = 0; t < target_nodes.size(); ++t) {
+      if (!loops[i] || hom[t][t])
+        domains[i].push_back(t);
     }
 
-    projections = std::move(update);
+    if (domains[i].empty())
+      return Arrow::List();
   }
 
+  TAssignment assignment(source_nodes.size(), sUnassigned);
+  std::list<TAssignment> solutions;
+
+  search_functors(hom, out, in, domains, assignment, solutions, matchCount_);
+
+  // Ordering solutions the same way "ProposeArrows" does
+  solutions.sort([](const TAssignment &left_, const TAssignment &right_) {
+    return std::lexicographical_compare(left_.rbegin(), left_.rend(),
+                                        right_.rbegin(), right_.rend());
+  });
+
   Arrow::List ret;
-  for (const auto &projection : projections) {
+  for (const auto &solution : solutions) {
     Arrow arrow(source, target);
 
-    for (const auto &[from, to] : projection) {
-      arrow.AddArrow(Arrow(from.Name(), to.Name()));
-    }
+    for (size_t i = 0; i < solution.size(); ++i)
+      arrow.AddArrow(Arrow(source_nodes[i].Name(),
+                           target_nodes[solution[i]].Name()));
 
     ret.push_back(std::move(arrow));
   }
@@ -958,7 +1241,8 @@ Arrow::List Node::ProposeArrows(const Node::NName &from_,
 
 //-----------------------------------------------------------------------------------------
 Arrow::List Node::SolveDetermination(const Arrow::AName &AB,
-                                     const Arrow::AName &AC) {
+                                     const Arrow::AName &AC,
+                                     SolverControl *control_) {
 
   Arrow::List ABlist = QueryArrows(Arrow("*", "*", AB).AsQuery());
   if (ABlist.empty()) {
@@ -974,24 +1258,31 @@ Arrow::List Node::SolveDetermination(const Arrow::AName &AB,
 
   Arrow &acArrow = AClist.front();
 
-  Arrow::List bcList = ProposeArrows(abArrow.Target(), acArrow.Target());
+  Node::List source_list = QueryNodes(abArrow.Target());
+  Node::List target_list = QueryNodes(acArrow.Target());
+  if (source_list.size() != 1 || target_list.size() != 1)
+    return {};
 
   Arrow::List ret;
-  for (const auto &BC : bcList) {
-    auto detComposeArrow = BC.Compose(abArrow);
-    if (detComposeArrow.has_value()) {
+  for_each_candidate(source_list.front(), target_list.front(), control_,
+                     [&](const Arrow &BC) {
+                       auto detComposeArrow = BC.Compose(abArrow);
+                       if (detComposeArrow.has_value()) {
 
-      if (detComposeArrow->IsAssociative(acArrow)) {
-        ret.push_back(BC);
-      }
-    }
-  }
+                         if (detComposeArrow->IsAssociative(acArrow)) {
+                           ret.push_back(BC);
+                         }
+                       }
+
+                       return true;
+                     });
 
   return ret;
 }
 
 //-----------------------------------------------------------------------------------------
-Arrow::List Node::SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC) {
+Arrow::List Node::SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC,
+                              SolverControl *control_) {
 
   Arrow::List BClist = QueryArrows(Arrow("*", "*", BC).AsQuery());
   if (BClist.empty()) {
@@ -1007,19 +1298,214 @@ Arrow::List Node::SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC) {
 
   Arrow &acArrow = AClist.front();
 
-  Arrow::List abList = ProposeArrows(acArrow.Source(), bcArrow.Source());
+  Node::List source_list = QueryNodes(acArrow.Source());
+  Node::List target_list = QueryNodes(bcArrow.Source());
+  if (source_list.size() != 1 || target_list.size() != 1)
+    return {};
 
   Arrow::List ret;
-  for (const auto &AB : abList) {
-    auto choiceComposeArrow = bcArrow.Compose(AB);
-    if (choiceComposeArrow.has_value()) {
+  for_each_candidate(source_list.front(), target_list.front(), control_,
+                     [&](const Arrow &AB) {
+                       auto choiceComposeArrow = bcArrow.Compose(AB);
+                       if (choiceComposeArrow.has_value()) {
+
+                         if (choiceComposeArrow->IsAssociative(acArrow)) {
+                           ret.push_back(AB);
+                         }
+                       }
+
+                       return true;
+                     });
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+static std::optional<size_t> count_candidates(size_t sources_,
+                                              size_t targets_) {
+  size_t count{1};
+  for (size_t i = 0; i < sources_; ++i) {
+    if (targets_ != 0 && count > std::numeric_limits<size_t>::max() / targets_)
+      return {};
+
+    count *= targets_;
+  }
+
+  return count;
+}
+
+//-----------------------------------------------------------------------------------------
+static Arrow make_candidate(const Node &source_, const Node &target_,
+                            const std::vector<Node> &source_nodes_,
+                            const std::vector<Node> &target_nodes_,
+                            size_t index_) {
+  Arrow arrow(source_, target_);
+
+  // The first source node changes fastest, see "ProposeArrows"
+  for (const Node &node : source_nodes_) {
+    arrow.AddArrow(Arrow(node.Name(),
+                         target_nodes_[index_ % target_nodes_.size()].Name()));
+    index_ /= target_nodes_.size();
+  }
+
+  return arrow;
+}
+
+//-----------------------------------------------------------------------------------------
+Arrow::List Node::SolveChoice(const Arrow::AName &BC, const Arrow::AName &AC,
+                              ThreadPool &pool_,
+                              std::optional<size_t> matchCount_,
+                              const TSolutionFn &onSolution_,
+                              SolverControl *control_) {
+  if (matchCount_ && matchCount_ == 0)
+    return {};
+
+  Arrow::List BClist = QueryArrows(Arrow("*", "*", BC).AsQuery());
+  if (BClist.empty()) {
+    return {};
+  }
+
+  const Arrow bcArrow = BClist.front();
+
+  Arrow::List AClist = QueryArrows(Arrow("*", "*", AC).AsQuery());
+  if (AClist.empty()) {
+    return {};
+  }
+
+  const Arrow acArrow = AClist.front();
+
+  Node::List source_list = QueryNodes(acArrow.Source());
+  Node::List target_list = QueryNodes(bcArrow.Source());
+  if (source_list.size() != 1 || target_list.size() != 1)
+    return {};
+
+  const Node source = source_list.front();
+  const Node target = target_list.front();
+
+  Node::List source_query = source.QueryNodes("*");
+  Node::List target_query = target.QueryNodes("*");
+
+  const std::vector<Node> source_nodes(source_query.begin(),
+                                       source_query.end());
+  const std::vector<Node> target_nodes(target_query.begin(),
+                                       target_query.end());
+
+  auto total = count_candidates(source_nodes.size(), target_nodes.size());
+  if (!total) {
+    print_error("Too many candidates for choice problem: " + BC + ", " + AC);
+    return {};
+  }
+
+  if (total.value() == 0)
+    return {};
+
+  // State shared by the workers. Workers which start after the search is over
+  // leave without touching it
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<size_t> next{};
+    std::atomic<bool> stop{};
+    bool finished{};
+    size_t running{};
+    std::exception_ptr error;
+    std::vector<std::pair<size_t, Arrow>> found;
+  };
+
+  auto state = std::make_shared<State>();
+
+  const size_t workers = pool_.Size() + 1;
+  const size_t chunk =
+      std::clamp<size_t>(total.value() / (workers * 8), 1, 256);
+
+  auto search = [=, &onSolution_]() {
+    while (!state->stop) {
+      size_t begin = state->next.fetch_add(chunk);
+      if (begin >= total.value())
+        break;
+
+      size_t end = std::min(begin + chunk, total.value());
+      for (size_t index = begin; index < end && !state->stop; ++index) {
+        if (control_ && !control_->Step()) {
+          state->stop = true;
+          break;
+        }
+
+        Arrow AB = make_candidate(source, target, source_nodes, target_nodes,
+                                  index);
 
-      if (choiceComposeArrow->IsAssociative(acArrow)) {
-        ret.push_back(AB);
+        auto choiceComposeArrow = bcArrow.Compose(AB);
+        if (!choiceComposeArrow.has_value() ||
+            !choiceComposeArrow->IsAssociative(acArrow))
+          continue;
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->stop)
+          break;
+
+        state->found.emplace_back(index, AB);
+
+        if (onSolution_ && !onSolution_(AB))
+          state->stop = true;
+
+        if (matchCount_ && state->found.size() >= matchCount_.value())
+          state->stop = true;
       }
     }
+  };
+
+  // Exception stops the search, the first one is passed to the caller
+  auto guarded = [state, search]() {
+    try {
+      search();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (!state->error)
+        state->error = std::current_exception();
+
+      state->stop = true;
+    }
+  };
+
+  for (size_t i = 1; i < workers; ++i) {
+    pool_.Submit([state, guarded]() {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->finished)
+          return;
+        ++state->running;
+      }
+
+      guarded();
+
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        --state->running;
+      }
+
+      state->cv.notify_all();
+    });
   }
 
+  // The calling thread takes part in the search as well
+  guarded();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished = true;
+  state->cv.wait(lock, [&]() { return state->running == 0; });
+
+  if (state->error)
+    std::rethrow_exception(state->error);
+
+  std::sort(state->found.begin(), state->found.end(),
+            [](const auto &left_, const auto &right_) {
+              return left_.first < right_.first;
+            });
+
+  Arrow::List ret;
+  for (auto &[_, arrow] : state->found)
+    ret.push_back(std::move(arrow));
+
   return ret;
 }
 
@@ -1039,11 +1525,116 @@ Node::EType Node::InternalNode() const {
 }
 
 //-----------------------------------------------------------------------------------------
-void Node::SetValue(const TSetValue &value_) { m_value = value_; }
+void Node::SetValue(const TSetValue &value_) {
+  static std::atomic<uint64_t> versions{};
+
+  m_value = value_;
+  m_version = ++versions;
+}
+
+//-----------------------------------------------------------------------------------------
+uint64_t Node::Version() const { return m_version; }
 
 //-----------------------------------------------------------------------------------------
 const TSetValue &Node::GetValue() const { return m_value; }
 
+//-----------------------------------------------------------------------------------------
+std::size_t Node::Hash() const {
+  return m_hash.Get([this]() {
+    std::size_t seed = std::hash<std::string>{}(m_name);
+    hash_combine(seed, static_cast<std::size_t>(m_type));
+
+    for (const auto &[node, _] : m_nodes)
+      hash_combine(seed, node.Hash());
+
+    // Sum keeps the hash independent of the order of arrows
+    std::size_t arrows{};
+    for (const Arrow &arrow : m_arrows)
+      arrows += hash_mix(arrow.Hash());
+
+    hash_combine(seed, arrows);
+
+    return seed;
+  });
+}
+
+//-----------------------------------------------------------------------------------------
+bool Node::SameStructure(const Node &node_) const {
+  if (Hash() != node_.Hash() || m_name != node_.m_name ||
+      m_type != node_.m_type || m_nodes.size() != node_.m_nodes.size() ||
+      m_arrows.size() != node_.m_arrows.size())
+    return false;
+
+  // Node tables are ordered by name
+  auto it = node_.m_nodes.begin();
+  for (const auto &[node, _] : m_nodes) {
+    if (!node.SameStructure(it->first))
+      return false;
+    ++it;
+  }
+
+  // Arrows are compared regardless of their order, as by the hash
+  auto fnSorted = [](const Arrow::List &arrows_) {
+    std::vector<const Arrow *> ret;
+    for (const Arrow &arrow : arrows_)
+      ret.push_back(&arrow);
+
+    std::sort(ret.begin(), ret.end(),
+              [](const Arrow *left_, const Arrow *right_) {
+                return std::tie(left_->Name(), left_->Source(),
+                                left_->Target()) <
+                       std::tie(right_->Name(), right_->Source(),
+                                right_->Target());
+              });
+    return ret;
+  };
+
+  auto left = fnSorted(m_arrows);
+  auto right = fnSorted(node_.m_arrows);
+  for (size_t i = 0; i < left.size(); ++i) {
+    if (*left[i] != *right[i])
+      return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+MemoryUsage Node::MemoryReport() const {
+  MemoryUsage ret;
+  TMemoryVisited visited;
+
+  MemoryReport(ret, visited);
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+void Node::MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const {
+  usage_.names += heap_size(m_name);
+
+  if (auto str = std::get_if<std::string>(&m_value))
+    usage_.values += heap_size(*str);
+  else if (auto tensor = std::get_if<Tensor>(&m_value))
+    tensor->MemoryReport(usage_, visited_);
+
+  for (const auto &[node, codomain] : m_nodes) {
+    usage_.nodes += heap_node_size(sizeof(Map::value_type), 3);
+    node.MemoryReport(usage_, visited_);
+
+    // Codomains keep their own copies of target nodes
+    for (const Node &target : codomain) {
+      usage_.nodes += heap_node_size(sizeof(Node), 3);
+      target.MemoryReport(usage_, visited_);
+    }
+  }
+
+  for (const Arrow &arrow : m_arrows) {
+    usage_.arrows += heap_node_size(sizeof(Arrow), 2);
+    arrow.MemoryReport(usage_, visited_);
+  }
+}
+
 //-----------------------------------------------------------------------------------------
 bool Node::validate_node_data() const {
   size_t sz{};
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <string.h>
 
+#include "counters.h"
 #include "log.h"
 
 using namespace cat;
@@ -430,6 +431,8 @@ Arrow::List Parser::QueryArrows(const std::string &query_,
   const auto &target = qarrow[0].Target();
   const auto &name = qarrow[0].Name();
 
+  count_operation(ECounter::eArrowScans, arrows_.size());
+
   Arrow::List ret;
 
   std::string sAny(1, ASTERISK::id);
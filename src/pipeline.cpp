@@ -0,0 +1,213 @@
+#include "pipeline.h"
+
+#include <chrono>
+
+#include "log.h"
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+// Waiting on lock-free queues: spinning first, then yielding, then sleeping
+static void backoff(size_t &spins_) {
+  if (++spins_ < 64)
+    return;
+
+  if (spins_ < 128)
+    std::this_thread::yield();
+  else
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+//-----------------------------------------------------------------------------------------
+std::unique_ptr<Pipeline> Pipeline::Create(const Plan &plan_,
+                                           size_t capacity_) {
+  if (plan_.hops.empty()) {
+    print_error("Pipeline of empty plan");
+    return nullptr;
+  }
+
+  for (const auto &hop : plan_.hops) {
+    if (hop.structural) {
+      print_error("Pipeline of arrow " + hop.arrow.Name() +
+                  " mapping internal nodes");
+      return nullptr;
+    }
+  }
+
+  return std::unique_ptr<Pipeline>(new Pipeline(plan_, capacity_));
+}
+
+//-----------------------------------------------------------------------------------------
+Pipeline::Pipeline(const Plan &plan_, size_t capacity_)
+    : m_plan(plan_), m_input(capacity_), m_output(capacity_) {
+  // Consecutive hops writing the same node make one stage
+  for (size_t i = 0; i < m_plan.hops.size(); ++i) {
+    if (m_stages.empty() ||
+        m_plan.hops[m_stages.back().back()].target != m_plan.hops[i].target)
+      m_stages.emplace_back();
+
+    m_stages.back().push_back(i);
+  }
+
+  for (size_t i = 1; i < m_stages.size(); ++i)
+    m_links.push_back(std::make_unique<SpscQueue<TRecord>>(capacity_));
+
+  for (size_t i = 0; i < m_stages.size(); ++i)
+    m_threads.emplace_back([this, i]() { stage(i); });
+}
+
+//-----------------------------------------------------------------------------------------
+Pipeline::~Pipeline() {
+  Close();
+  m_stop = true;
+
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+//-----------------------------------------------------------------------------------------
+auto Pipeline::MakeRecord(const Node &node_) const -> std::optional<TRecord> {
+  TRecord ret;
+  ret.reserve(m_plan.slots.size());
+
+  for (const auto &name : m_plan.slots) {
+    const Node *node = node_.FindNode(name);
+    if (!node)
+      return {};
+
+    ret.push_back(node->GetValue());
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Pipeline::Push(TRecord record_) {
+  if (record_.size() != m_plan.slots.size())
+    return false;
+
+  // Pushers are counted, so that the first stage doesn't finish under them
+  ++m_pushing;
+
+  size_t spins{};
+  bool ret = false;
+  while (!m_closed && !ret) {
+    ret = m_input.TryPush(record_);
+    if (!ret)
+      backoff(spins);
+  }
+
+  --m_pushing;
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+auto Pipeline::Pop() -> std::optional<TRecord> {
+  TRecord ret;
+
+  size_t spins{};
+  while (true) {
+    if (m_output.TryPop(ret))
+      return ret;
+
+    // Last stage pushes all its records before it finishes
+    if (m_finished == m_stages.size()) {
+      if (m_output.TryPop(ret))
+        return ret;
+
+      return {};
+    }
+
+    backoff(spins);
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+void Pipeline::Close() { m_closed = true; }
+
+//-----------------------------------------------------------------------------------------
+size_t Pipeline::Stages() const { return m_stages.size(); }
+
+//-----------------------------------------------------------------------------------------
+size_t Pipeline::Dropped() const { return m_dropped; }
+
+//-----------------------------------------------------------------------------------------
+const Plan &Pipeline::GetPlan() const { return m_plan; }
+
+//-----------------------------------------------------------------------------------------
+void Pipeline::stage(size_t index_) {
+  TRecord record;
+
+  size_t spins{};
+  while (!m_stop) {
+    if (!pop(index_, record)) {
+      // Upstream is done once the input is closed and the stages before
+      // have finished
+      bool done = m_closed && m_pushing == 0 && m_finished == index_;
+      if (done && !pop(index_, record))
+        break;
+
+      if (!done) {
+        backoff(spins);
+        continue;
+      }
+    }
+
+    spins = 0;
+
+    // Throwing function drops the record, the stage keeps running
+    bool ok = true;
+    for (size_t hop : m_stages[index_]) {
+      const Plan::Hop &current = m_plan.hops[hop];
+      try {
+        ok = ok && m_plan.Apply(current, record);
+      } catch (const std::exception &e_) {
+        print_error("Arrow " + current.arrow.Name() + " failed: " + e_.what());
+        ok = false;
+      } catch (...) {
+        print_error("Arrow " + current.arrow.Name() + " failed");
+        ok = false;
+      }
+    }
+
+    if (!ok) {
+      ++m_dropped;
+      continue;
+    }
+
+    if (!push(index_, record))
+      break;
+  }
+
+  // Stages finish in order, the next one waits for this one to drain
+  while (m_finished != index_)
+    std::this_thread::yield();
+
+  ++m_finished;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Pipeline::pop(size_t index_, TRecord &record_) {
+  if (index_ == 0)
+    return m_input.TryPop(record_);
+
+  return m_links[index_ - 1]->TryPop(record_);
+}
+
+//-----------------------------------------------------------------------------------------
+bool Pipeline::push(size_t index_, TRecord &record_) {
+  size_t spins{};
+
+  while (!m_stop) {
+    bool pushed = index_ + 1 == m_stages.size()
+                      ? m_output.TryPush(record_)
+                      : m_links[index_]->TryPush(record_);
+    if (pushed)
+      return true;
+
+    backoff(spins);
+  }
+
+  return false;
+}
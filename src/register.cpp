@@ -2,8 +2,38 @@
 
 #include "register.h"
 
+#include <array>
+
 using namespace cat;
 
+namespace {
+// Every publication of any register gets its own generation, so that cached
+// snapshots of different registers are never confused
+std::atomic<size_t> g_generations{};
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+std::size_t Register::KeyHasher::operator()(const Arrow &arrow_) const {
+  std::hash<std::string> hasher;
+
+  std::size_t ret = hasher(arrow_.Source());
+  hash_combine(ret, hasher(arrow_.Target()));
+  hash_combine(ret, hasher(arrow_.Name()));
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+bool Register::KeyEqual::operator()(const Arrow &left_,
+                                    const Arrow &right_) const {
+  return !(left_ < right_) && !(right_ < left_);
+}
+
+//-----------------------------------------------------------------------------------------
+Register::Register()
+    : m_snapshot(std::make_shared<const TEntries>()),
+      m_generation(++g_generations) {}
+
 //-----------------------------------------------------------------------------------------
 Register &Register::Inst() {
   static Register reg;
@@ -12,18 +42,258 @@ Register &Register::Inst() {
 
 //-----------------------------------------------------------------------------------------
 void Register::Reg(const Arrow &arrow_, const TFn &fn_) {
-  m_functions[arrow_] = fn_;
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  reg(arrow_, fn_);
+  publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+void Register::Unreg(const Arrow &arrow_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_functions.erase(arrow_);
+  m_batches.erase(arrow_);
+  m_typed.erase(arrow_);
+  m_memos.erase(arrow_);
+  m_async.erase(arrow_);
+  publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::Get(const Arrow &arrow_) const -> TFn {
+  const Entry *entry = Find(snapshot(), arrow_);
+  if (entry && entry->fn) {
+    return entry->fn;
+  }
+  return [](auto arg_) { return arg_; };
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::Snapshot() const -> TSnapshot { return snapshot(); }
+
+//-----------------------------------------------------------------------------------------
+auto Register::Find(const TSnapshot &snapshot_, const Arrow &arrow_)
+    -> const Entry * {
+  auto it = snapshot_->find(arrow_);
+  return it != snapshot_->end() ? &it->second : nullptr;
 }
 
 //-----------------------------------------------------------------------------------------
-void Register::Unreg(const Arrow &arrow_) { m_functions.erase(arrow_); }
+void Register::RegAsync(const Arrow &arrow_, const TAsyncFn &fn_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Synchronous executions wait for the result
+  reg(arrow_, [fn_](TSetValue arg_) { return fn_(arg_).get(); });
+  m_async[arrow_] = fn_;
+  publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::GetAsync(const Arrow &arrow_) const -> TAsyncFn {
+  const Entry *entry = Find(snapshot(), arrow_);
+  return entry ? entry->async : TAsyncFn();
+}
 
 //-----------------------------------------------------------------------------------------
-auto Register::Get(const Arrow &arrow_) -> const TFn & {
-  static TFn stub = [](auto arg_) { return arg_; };
+void Register::RegBatch(const Arrow &arrow_, const TBatchFn &fn_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_batches[arrow_] = fn_;
+  publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::GetBatch(const Arrow &arrow_) const -> TBatchFn {
+  const Entry *entry = Find(snapshot(), arrow_);
+  return entry ? entry->batch : TBatchFn();
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::GetSignature(const Arrow &arrow_) const
+    -> std::optional<Signature> {
+  const Entry *entry = Find(snapshot(), arrow_);
+  if (!entry)
+    return {};
+
+  return entry->signature;
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::GetInvoker(const Arrow &arrow_) const -> TInvoker {
+  const Entry *entry = Find(snapshot(), arrow_);
+  return entry ? entry->invoker : TInvoker();
+}
+
+//-----------------------------------------------------------------------------------------
+bool Register::Memoize(const Arrow &arrow_, size_t capacity_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
   auto it = m_functions.find(arrow_);
-  if (it != m_functions.end()) {
-    return it->second;
+  if (it == m_functions.end())
+    return false;
+
+  auto memo = std::make_shared<Memo>(capacity_);
+
+  TFn fn = [memo, fn = it->second](TSetValue arg_) {
+    if (auto ret = memo->Find(arg_))
+      return std::move(ret.value());
+
+    TSetValue ret = fn(arg_);
+    memo->Insert(arg_, ret);
+
+    return ret;
+  };
+
+  TInvoker invoker;
+  auto itTyped = m_typed.find(arrow_);
+  if (itTyped != m_typed.end()) {
+    invoker = [memo, invoker = itTyped->second.invoker](const TSetValue &arg_,
+                                                        TSetValue &ret_) {
+      if (auto ret = memo->Find(arg_)) {
+        ret_ = std::move(ret.value());
+        return true;
+      }
+
+      if (!invoker(arg_, ret_))
+        return false;
+
+      memo->Insert(arg_, ret_);
+      return true;
+    };
+  }
+
+  m_memos[arrow_] = {memo, std::move(fn), std::move(invoker)};
+  publish(arrow_);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+void Register::Unmemoize(const Arrow &arrow_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_memos.erase(arrow_))
+    publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::GetMemoStats(const Arrow &arrow_) const
+    -> std::optional<Memo::Stats> {
+  const Entry *entry = Find(snapshot(), arrow_);
+  if (!entry || !entry->memo)
+    return {};
+
+  return entry->memo->GetStats();
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Register::Generation() const {
+  return m_generation.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------------------
+void Register::regTyped(const Arrow &arrow_, TFn fn_, Signature signature_,
+                        TInvoker invoker_, TBatchFn batch_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  reg(arrow_, fn_);
+  m_typed[arrow_] = {signature_, std::move(invoker_), std::move(batch_)};
+  publish(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+void Register::reg(const Arrow &arrow_, const TFn &fn_) {
+  m_functions[arrow_] = fn_;
+  m_typed.erase(arrow_);
+  m_memos.erase(arrow_);
+  m_async.erase(arrow_);
+}
+
+//-----------------------------------------------------------------------------------------
+void Register::publish(const Arrow &arrow_) {
+  Entry entry;
+
+  auto itFn = m_functions.find(arrow_);
+  if (itFn != m_functions.end())
+    entry.fn = itFn->second;
+
+  auto itTyped = m_typed.find(arrow_);
+  if (itTyped != m_typed.end()) {
+    entry.signature = itTyped->second.signature;
+    entry.invoker = itTyped->second.invoker;
+    entry.batch = itTyped->second.batch;
   }
-  return stub;
+
+  // Explicit kernel has priority over the typed function
+  auto itBatch = m_batches.find(arrow_);
+  if (itBatch != m_batches.end())
+    entry.batch = itBatch->second;
+
+  auto itMemo = m_memos.find(arrow_);
+  if (itMemo != m_memos.end()) {
+    entry.fn = itMemo->second.fn;
+    entry.memo = itMemo->second.memo;
+    if (itMemo->second.invoker)
+      entry.invoker = itMemo->second.invoker;
+  }
+
+  auto itAsync = m_async.find(arrow_);
+  if (itAsync != m_async.end())
+    entry.async = itAsync->second;
+
+  auto entries = std::make_shared<TEntries>(*m_snapshot);
+
+  bool empty = !entry.fn && !entry.batch && !entry.async;
+  if (empty)
+    entries->erase(arrow_);
+  else
+    entries->insert_or_assign(arrow_, std::move(entry));
+
+  // Snapshot goes first, readers seeing the new generation find it
+  std::atomic_store_explicit(&m_snapshot, TSnapshot(std::move(entries)),
+                             std::memory_order_release);
+  m_generation.store(++g_generations, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------
+auto Register::snapshot() const -> const TSnapshot & {
+  // Snapshot is cached by thread until the register publishes a new one.
+  // Checking the generation is the only shared access on the way. A few
+  // registers are cached at once, so that alternating between them stays on
+  // the lock-free path; generations are unique, a register created at the
+  // address of a destroyed one never matches its slot
+  struct Cache {
+    const Register *owner{};
+    size_t generation{};
+    TSnapshot snapshot;
+  };
+
+  thread_local std::array<Cache, 4> caches;
+  thread_local size_t next{};
+
+  size_t generation = m_generation.load(std::memory_order_acquire);
+
+  Cache *cache = nullptr;
+  for (Cache &slot : caches) {
+    if (slot.owner == this) {
+      cache = &slot;
+      break;
+    }
+  }
+
+  // Slots of other registers are replaced in turn
+  if (!cache) {
+    cache = &caches[next++ % caches.size()];
+    cache->owner = this;
+    cache->generation = 0;
+  }
+
+  if (cache->generation != generation) {
+    cache->snapshot =
+        std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
+    cache->generation = generation;
+  }
+
+  return cache->snapshot;
 }
@@ -0,0 +1,44 @@
+#include "solver_control.h"
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+void SolverControl::SetTimeout(TClock::duration timeout_) {
+  m_deadline = TClock::now() + timeout_;
+}
+
+//-----------------------------------------------------------------------------------------
+void SolverControl::SetDeadline(TClock::time_point deadline_) {
+  m_deadline = deadline_;
+}
+
+//-----------------------------------------------------------------------------------------
+void SolverControl::SetBudget(size_t operations_) { m_budget = operations_; }
+
+//-----------------------------------------------------------------------------------------
+void SolverControl::Cancel() { m_cancelled = true; }
+
+//-----------------------------------------------------------------------------------------
+bool SolverControl::IsCancelled() const { return m_cancelled; }
+
+//-----------------------------------------------------------------------------------------
+bool SolverControl::Step(size_t operations_) {
+  if (m_truncated)
+    return false;
+
+  size_t operations = m_operations.fetch_add(operations_) + operations_;
+
+  if (m_cancelled || (m_budget && operations > m_budget.value()) ||
+      (m_deadline && TClock::now() >= m_deadline.value())) {
+    m_truncated = true;
+    return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+bool SolverControl::IsTruncated() const { return m_truncated; }
+
+//-----------------------------------------------------------------------------------------
+size_t SolverControl::Operations() const { return m_operations; }
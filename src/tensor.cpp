@@ -0,0 +1,185 @@
+#include "tensor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "hash.h"
+#include "log.h"
+
+using namespace cat;
+
+//-----------------------------------------------------------------------------------------
+Tensor::Tensor() : Tensor(std::vector<double>()) {}
+
+//-----------------------------------------------------------------------------------------
+Tensor::Tensor(std::vector<double> data_) : m_shape({data_.size()}) {
+  m_buffer = std::make_shared<const std::vector<double>>(std::move(data_));
+}
+
+//-----------------------------------------------------------------------------------------
+Tensor::Tensor(std::shared_ptr<const std::vector<double>> buffer_,
+               std::size_t offset_, TShape shape_)
+    : m_buffer(std::move(buffer_)), m_offset(offset_),
+      m_shape(std::move(shape_)) {}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Tensor> Tensor::Create(std::vector<double> data_,
+                                     TShape shape_) {
+  if (shape_.empty() || elements(shape_) != data_.size()) {
+    print_error("Tensor of " + std::to_string(data_.size()) +
+                " elements doesn't fit the shape");
+    return {};
+  }
+
+  auto buffer = std::make_shared<const std::vector<double>>(std::move(data_));
+  return Tensor(std::move(buffer), 0, std::move(shape_));
+}
+
+//-----------------------------------------------------------------------------------------
+const Tensor::TShape &Tensor::Shape() const { return m_shape; }
+
+//-----------------------------------------------------------------------------------------
+std::size_t Tensor::Rank() const { return m_shape.size(); }
+
+//-----------------------------------------------------------------------------------------
+std::size_t Tensor::Size() const { return elements(m_shape); }
+
+//-----------------------------------------------------------------------------------------
+const double *Tensor::Data() const { return m_buffer->data() + m_offset; }
+
+//-----------------------------------------------------------------------------------------
+const double *Tensor::begin() const { return Data(); }
+
+//-----------------------------------------------------------------------------------------
+const double *Tensor::end() const { return Data() + Size(); }
+
+//-----------------------------------------------------------------------------------------
+double Tensor::operator[](std::size_t index_) const { return Data()[index_]; }
+
+//-----------------------------------------------------------------------------------------
+std::optional<double> Tensor::At(const std::vector<std::size_t> &index_) const {
+  if (index_.size() != m_shape.size())
+    return {};
+
+  std::size_t flat{};
+  for (std::size_t dim = 0; dim < m_shape.size(); ++dim) {
+    if (index_[dim] >= m_shape[dim])
+      return {};
+
+    flat = flat * m_shape[dim] + index_[dim];
+  }
+
+  return Data()[flat];
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Tensor> Tensor::Slice(std::size_t begin_,
+                                    std::size_t end_) const {
+  if (begin_ > end_ || end_ > m_shape.front()) {
+    print_error("Slice [" + std::to_string(begin_) + ", " +
+                std::to_string(end_) + ") is out of tensor");
+    return {};
+  }
+
+  // Rows are contiguous, slice only moves the offset
+  TShape shape = m_shape;
+  shape.front() = end_ - begin_;
+
+  std::size_t row = elements(TShape(m_shape.begin() + 1, m_shape.end()));
+
+  return Tensor(m_buffer, m_offset + begin_ * row, std::move(shape));
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<Tensor> Tensor::Reshape(TShape shape_) const {
+  if (shape_.empty() || elements(shape_) != Size()) {
+    print_error("Tensor of " + std::to_string(Size()) +
+                " elements doesn't fit the shape");
+    return {};
+  }
+
+  return Tensor(m_buffer, m_offset, std::move(shape_));
+}
+
+//-----------------------------------------------------------------------------------------
+Tensor Tensor::Transform(const std::function<double(double)> &fn_) const {
+  std::vector<double> data(Size());
+  std::transform(begin(), end(), data.begin(), fn_);
+
+  auto buffer = std::make_shared<const std::vector<double>>(std::move(data));
+  return Tensor(std::move(buffer), 0, m_shape);
+}
+
+//-----------------------------------------------------------------------------------------
+std::vector<double> Tensor::ToVector() const {
+  return std::vector<double>(begin(), end());
+}
+
+//-----------------------------------------------------------------------------------------
+bool Tensor::SharesBuffer(const Tensor &other_) const {
+  return m_buffer == other_.m_buffer;
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t Tensor::Hash() const {
+  std::size_t ret{};
+  for (std::size_t dim : m_shape)
+    hash_combine(ret, dim);
+
+  for (double element : *this) {
+    // Equal elements have equal hashes, zeros of both signs included
+    element = element == 0.0 ? 0.0 : element;
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &element, sizeof(bits));
+    hash_combine(ret, std::size_t(bits));
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+void Tensor::MemoryReport(MemoryUsage &usage_, TMemoryVisited &visited_) const {
+  usage_.values += m_shape.capacity() * sizeof(std::size_t);
+
+  if (!visited_.insert(m_buffer.get()).second)
+    return;
+
+  usage_.values += heap_shared_size(sizeof(std::vector<double>)) +
+                   m_buffer->capacity() * sizeof(double);
+}
+
+//-----------------------------------------------------------------------------------------
+bool Tensor::operator==(const Tensor &other_) const {
+  if (m_shape != other_.m_shape)
+    return false;
+
+  if (m_buffer == other_.m_buffer && m_offset == other_.m_offset)
+    return true;
+
+  return std::equal(begin(), end(), other_.begin());
+}
+
+//-----------------------------------------------------------------------------------------
+bool Tensor::operator!=(const Tensor &other_) const {
+  return !(*this == other_);
+}
+
+//-----------------------------------------------------------------------------------------
+bool Tensor::operator<(const Tensor &other_) const {
+  if (m_shape != other_.m_shape)
+    return m_shape < other_.m_shape;
+
+  return std::lexicographical_compare(begin(), end(), other_.begin(),
+                                      other_.end());
+}
+
+//-----------------------------------------------------------------------------------------
+std::size_t Tensor::elements(const TShape &shape_) {
+  std::size_t ret{1};
+  for (std::size_t dim : shape_)
+    ret *= dim;
+
+  return ret;
+}
@@ -0,0 +1,191 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "log.h"
+
+using namespace cat;
+
+namespace {
+// Pool and queue of the current worker thread
+thread_local const ThreadPool *tl_pool{};
+thread_local size_t tl_index{};
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threads_) {
+  threads_ = std::max<size_t>(threads_, 1);
+
+  m_queues.reserve(threads_);
+  for (size_t i = 0; i < threads_; ++i)
+    m_queues.push_back(std::make_unique<Queue>());
+
+  m_threads.reserve(threads_);
+  for (size_t i = 0; i < threads_; ++i)
+    m_threads.emplace_back([this, i]() { worker(i); });
+}
+
+//-----------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_cv.notify_all();
+
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+//-----------------------------------------------------------------------------------------
+ThreadPool &ThreadPool::Inst() {
+  static ThreadPool pool;
+  return pool;
+}
+
+//-----------------------------------------------------------------------------------------
+void ThreadPool::Submit(TTask task_) {
+  // Workers keep their own tasks local, other threads spread tasks evenly
+  size_t index = tl_pool == this ? tl_index : m_next++ % m_queues.size();
+
+  // Counted ahead of queueing, so that taking never gets below zero
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_pending;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(std::move(task_));
+  }
+
+  m_cv.notify_one();
+}
+
+//-----------------------------------------------------------------------------------------
+bool ThreadPool::RunPending() {
+  TTask task;
+  if (!take(tl_pool == this ? tl_index : 0, task))
+    return false;
+
+  run(task);
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------
+void ThreadPool::ForEach(size_t count_,
+                         const std::function<void(size_t)> &fn_) {
+  if (count_ == 0)
+    return;
+
+  struct State {
+    std::atomic<size_t> next{};
+    size_t done{};
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  auto state = std::make_shared<State>();
+
+  // Indices are claimed one by one, so uneven calls balance out
+  TTask work = [state, count_, &fn_]() {
+    for (size_t index; (index = state->next++) < count_;) {
+      std::exception_ptr error;
+      try {
+        fn_(index);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      // Counted even on failure, otherwise the caller waits forever
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (error && !state->error)
+        state->error = error;
+      if (++state->done == count_)
+        state->cv.notify_all();
+    }
+  };
+
+  size_t helpers = std::min(Size(), count_ - 1);
+  for (size_t i = 0; i < helpers; ++i)
+    Submit(work);
+
+  work();
+
+  // All indices are claimed, the rest is finishing on workers
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&]() { return state->done == count_; });
+
+  if (state->error)
+    std::rethrow_exception(state->error);
+}
+
+//-----------------------------------------------------------------------------------------
+size_t ThreadPool::Size() const { return m_threads.size(); }
+
+//-----------------------------------------------------------------------------------------
+void ThreadPool::worker(size_t index_) {
+  tl_pool = this;
+  tl_index = index_;
+
+  while (true) {
+    TTask task;
+
+    if (take(index_, task)) {
+      run(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_stop || m_pending > 0; });
+
+    if (m_stop && m_pending == 0)
+      return;
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+bool ThreadPool::take(size_t index_, TTask &task_) {
+  if (m_pending == 0)
+    return false;
+
+  // Own queue is used as a stack, the newest task has the hottest data
+  {
+    Queue &own = *m_queues[index_];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task_ = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      --m_pending;
+      return true;
+    }
+  }
+
+  // Stealing the oldest task of other queues
+  for (size_t i = 1; i < m_queues.size(); ++i) {
+    Queue &other = *m_queues[(index_ + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(other.mutex);
+    if (!other.tasks.empty()) {
+      task_ = std::move(other.tasks.front());
+      other.tasks.pop_front();
+      --m_pending;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------------------
+void ThreadPool::run(TTask &task_) {
+  try {
+    task_();
+  } catch (const std::exception &e_) {
+    print_error(std::string("Task failure: ") + e_.what());
+  } catch (...) {
+    print_error("Task failure");
+  }
+}
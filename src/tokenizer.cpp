@@ -3,6 +3,8 @@
 #include <regex>
 #include <tuple>
 
+#include "counters.h"
+
 using namespace cat;
 
 //-----------------------------------------------------------------------------------------
@@ -194,6 +196,8 @@ enum class EParseState { eInitial, eToken, eTokenString, eService };
 
 //-----------------------------------------------------------------------------------------
 std::list<TToken> Tokenizer::Process(const std::string &string_) {
+  count_operation(ECounter::eTokenizerCalls);
+
   SMNode *crtSMNode{};
   SMNode root;
   build_seq_tree(root);
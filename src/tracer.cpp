@@ -0,0 +1,287 @@
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "log.h"
+
+using namespace cat;
+
+namespace {
+// Sub-buckets per power of two
+constexpr size_t sub_bits = 4;
+constexpr size_t sub_count = size_t(1) << sub_bits;
+
+// Escapes string for JSON
+std::string escape(const std::string &str_) {
+  std::string ret;
+  ret.reserve(str_.size());
+
+  for (char c : str_) {
+    switch (c) {
+    case '"':
+      ret += "\\\"";
+      break;
+    case '\\':
+      ret += "\\\\";
+      break;
+    case '\n':
+      ret += "\\n";
+      break;
+    case '\t':
+      ret += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        ret += buf;
+      } else {
+        ret += c;
+      }
+    }
+  }
+
+  return ret;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+void Histogram::Record(uint64_t value_) {
+  size_t index = bucket(value_);
+  if (m_buckets.size() <= index)
+    m_buckets.resize(index + 1);
+
+  ++m_buckets[index];
+
+  m_min = m_count ? std::min(m_min, value_) : value_;
+  m_max = std::max(m_max, value_);
+  m_total += value_;
+  ++m_count;
+}
+
+//-----------------------------------------------------------------------------------------
+void Histogram::Merge(const Histogram &other_) {
+  if (!other_.m_count)
+    return;
+
+  if (m_buckets.size() < other_.m_buckets.size())
+    m_buckets.resize(other_.m_buckets.size());
+
+  for (size_t i = 0; i < other_.m_buckets.size(); ++i)
+    m_buckets[i] += other_.m_buckets[i];
+
+  m_min = m_count ? std::min(m_min, other_.m_min) : other_.m_min;
+  m_max = std::max(m_max, other_.m_max);
+  m_total += other_.m_total;
+  m_count += other_.m_count;
+}
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::Count() const { return m_count; }
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::Total() const { return m_total; }
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::Min() const { return m_min; }
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::Max() const { return m_max; }
+
+//-----------------------------------------------------------------------------------------
+double Histogram::Mean() const {
+  return m_count ? double(m_total) / m_count : 0.0;
+}
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::Percentile(double percentile_) const {
+  if (!m_count)
+    return 0;
+
+  percentile_ = std::clamp(percentile_, 0.0, 100.0);
+  auto rank = std::max<uint64_t>(
+      1, uint64_t(std::ceil(percentile_ / 100.0 * m_count)));
+
+  uint64_t seen{};
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank)
+      return std::clamp(upper_bound(i), m_min, m_max);
+  }
+
+  return m_max;
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Histogram::bucket(uint64_t value_) {
+  if (value_ < sub_count)
+    return value_;
+
+  size_t exponent{};
+  while ((value_ >> exponent) >= 2 * sub_count)
+    ++exponent;
+
+  // Leading sub_bits + 1 bits of value select the bucket
+  return (exponent + 1) * sub_count + ((value_ >> exponent) - sub_count);
+}
+
+//-----------------------------------------------------------------------------------------
+uint64_t Histogram::upper_bound(size_t bucket_) {
+  if (bucket_ < sub_count)
+    return bucket_;
+
+  size_t exponent = bucket_ / sub_count - 1;
+  uint64_t mantissa = sub_count + bucket_ % sub_count;
+
+  return ((mantissa + 1) << exponent) - 1;
+}
+
+//-----------------------------------------------------------------------------------------
+Tracer::Scope::Scope(Tracer *tracer_, ECategory category_,
+                     const std::string &name_)
+    : m_tracer(tracer_), m_category(category_), m_name(name_) {
+  if (m_tracer)
+    m_start = std::chrono::steady_clock::now();
+}
+
+//-----------------------------------------------------------------------------------------
+Tracer::Scope::~Scope() {
+  if (m_tracer)
+    m_tracer->Record(m_category, m_name, m_start,
+                     std::chrono::steady_clock::now());
+}
+
+//-----------------------------------------------------------------------------------------
+Tracer::Tracer() : m_epoch(std::chrono::steady_clock::now()) {}
+
+//-----------------------------------------------------------------------------------------
+void Tracer::EnableEvents(bool enabled_) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_events = enabled_;
+}
+
+//-----------------------------------------------------------------------------------------
+void Tracer::Record(ECategory category_, const std::string &name_,
+                    std::chrono::steady_clock::time_point start_,
+                    std::chrono::steady_clock::time_point end_) {
+  using namespace std::chrono;
+
+  auto duration = uint64_t(duration_cast<nanoseconds>(end_ - start_).count());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  Stats &stats = m_stats[{category_, name_}];
+  ++stats.calls;
+  stats.latency.Record(duration);
+
+  if (!m_events)
+    return;
+
+  auto start = uint64_t(duration_cast<nanoseconds>(start_ - m_epoch).count());
+  m_log.push_back({category_, name_, start, duration,
+                   thread_index(std::this_thread::get_id())});
+}
+
+//-----------------------------------------------------------------------------------------
+Tracer::Stats Tracer::GetStats(ECategory category_,
+                               const std::string &name_) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto it = m_stats.find({category_, name_});
+  if (it == m_stats.end())
+    return {};
+
+  return it->second;
+}
+
+//-----------------------------------------------------------------------------------------
+std::map<std::string, Tracer::Stats>
+Tracer::GetStats(ECategory category_) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  std::map<std::string, Stats> ret;
+  for (auto it = m_stats.lower_bound({category_, std::string()});
+       it != m_stats.end() && it->first.first == category_; ++it) {
+    ret.emplace(it->first.second, it->second);
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+std::vector<Tracer::Event> Tracer::GetEvents() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_log;
+}
+
+//-----------------------------------------------------------------------------------------
+std::string Tracer::ChromeTrace() const {
+  std::vector<Event> events = GetEvents();
+
+  // Complete events, timestamps in microseconds
+  std::ostringstream out;
+  out.precision(3);
+  out << std::fixed << "{\"traceEvents\":[";
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    const Event &event = events[i];
+
+    out << (i ? "," : "") << "\n{\"name\":\"" << escape(event.name)
+        << "\",\"cat\":\"" << CategoryName(event.category)
+        << "\",\"ph\":\"X\",\"ts\":" << event.start / 1000.0
+        << ",\"dur\":" << event.duration / 1000.0
+        << ",\"pid\":1,\"tid\":" << event.thread << "}";
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+  return out.str();
+}
+
+//-----------------------------------------------------------------------------------------
+bool Tracer::WriteChromeTrace(const std::string &path_) const {
+  std::ofstream file(path_, std::ios::binary);
+  if (!file) {
+    print_error("Can't open file " + path_);
+    return false;
+  }
+
+  file << ChromeTrace();
+
+  return bool(file);
+}
+
+//-----------------------------------------------------------------------------------------
+void Tracer::Reset() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.clear();
+  m_log.clear();
+  m_threads.clear();
+}
+
+//-----------------------------------------------------------------------------------------
+const char *Tracer::CategoryName(ECategory category_) {
+  switch (category_) {
+  case ECategory::eArrow:
+    return "arrow";
+  case ECategory::eMap:
+    return "map";
+  case ECategory::eReplace:
+    return "replace";
+  case ECategory::eResolve:
+    return "resolve";
+  case ECategory::eRun:
+    return "run";
+  }
+
+  return "";
+}
+
+//-----------------------------------------------------------------------------------------
+size_t Tracer::thread_index(std::thread::id id_) {
+  return m_threads.emplace(id_, m_threads.size()).first->second;
+}
@@ -0,0 +1,215 @@
+#include "value_store.h"
+
+#include "executor.h"
+
+#include <cstdint>
+#include <type_traits>
+
+using namespace cat;
+
+namespace {
+// Values are written in native byte order
+template <typename T> void write_pod(std::ostream &out_, const T &value_) {
+  out_.write(reinterpret_cast<const char *>(&value_), sizeof(value_));
+}
+
+template <typename T> bool read_pod(std::istream &in_, T &value_) {
+  return bool(in_.read(reinterpret_cast<char *>(&value_), sizeof(value_)));
+}
+
+// Guards allocations of malformed data
+bool read_size(std::istream &in_, uint64_t &size_) {
+  return read_pod(in_, size_) && size_ < (uint64_t(1) << 40);
+}
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+ValueStore::ValueStore(size_t size_) : m_values(size_) {}
+
+//-----------------------------------------------------------------------------------------
+std::optional<ValueStore> ValueStore::Load(const Plan &plan_,
+                                           const Node &node_) {
+  ValueStore ret;
+  ret.m_values.reserve(plan_.slots.size());
+
+  for (const auto &name : plan_.slots) {
+    const Node *node = node_.FindNode(name);
+    if (!node) {
+      return {};
+    }
+
+    ret.m_values.push_back(node->GetValue());
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+void ValueStore::Store(const Plan &plan_, Node &node_) const {
+  std::vector<bool> written(plan_.slots.size());
+  for (const auto &hop : plan_.hops)
+    written[hop.target] = true;
+
+  for (size_t slot = 0; slot < plan_.slots.size() && slot < Size(); ++slot) {
+    if (written[slot])
+      node_.SetNodeValue(plan_.slots[slot], m_values[slot]);
+  }
+}
+
+//-----------------------------------------------------------------------------------------
+bool ValueStore::Write(std::ostream &out_) const {
+  write_pod(out_, uint64_t(m_values.size()));
+
+  for (const auto &value : m_values) {
+    write_pod(out_, uint8_t(value.index()));
+
+    std::visit(
+        [&](const auto &value_) {
+          using T = std::decay_t<decltype(value_)>;
+
+          if constexpr (std::is_same_v<T, std::string>) {
+            write_pod(out_, uint64_t(value_.size()));
+            out_.write(value_.data(), value_.size());
+          } else if constexpr (std::is_same_v<T, Tensor>) {
+            write_pod(out_, uint64_t(value_.Rank()));
+            for (size_t dim : value_.Shape())
+              write_pod(out_, uint64_t(dim));
+            out_.write(reinterpret_cast<const char *>(value_.Data()),
+                       value_.Size() * sizeof(double));
+          } else {
+            write_pod(out_, value_);
+          }
+        },
+        value);
+  }
+
+  return bool(out_);
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<ValueStore> ValueStore::Read(std::istream &in_) {
+  uint64_t size;
+  if (!read_size(in_, size))
+    return {};
+
+  ValueStore ret;
+  ret.m_values.reserve(size);
+
+  for (uint64_t i = 0; i < size; ++i) {
+    uint8_t type;
+    if (!read_pod(in_, type))
+      return {};
+
+    switch (ESetTypes(type)) {
+    case ESetTypes::eDouble: {
+      double value;
+      if (!read_pod(in_, value))
+        return {};
+      ret.m_values.emplace_back(value);
+      break;
+    }
+    case ESetTypes::eFloat: {
+      float value;
+      if (!read_pod(in_, value))
+        return {};
+      ret.m_values.emplace_back(value);
+      break;
+    }
+    case ESetTypes::eInt: {
+      int value;
+      if (!read_pod(in_, value))
+        return {};
+      ret.m_values.emplace_back(value);
+      break;
+    }
+    case ESetTypes::eString: {
+      uint64_t length;
+      if (!read_size(in_, length))
+        return {};
+
+      std::string value(length, '\0');
+      if (!in_.read(value.data(), length))
+        return {};
+      ret.m_values.emplace_back(std::move(value));
+      break;
+    }
+    case ESetTypes::eTensor: {
+      uint64_t rank;
+      if (!read_size(in_, rank) || rank == 0)
+        return {};
+
+      Tensor::TShape shape(rank);
+      uint64_t elements{1};
+      for (auto &dim : shape) {
+        uint64_t value;
+        if (!read_size(in_, value) ||
+            (value && elements > (uint64_t(1) << 40) / value))
+          return {};
+        dim = value;
+        elements *= value;
+      }
+
+      std::vector<double> data(elements);
+      if (!in_.read(reinterpret_cast<char *>(data.data()),
+                    elements * sizeof(double)))
+        return {};
+
+      auto tensor = Tensor::Create(std::move(data), std::move(shape));
+      if (!tensor.has_value())
+        return {};
+      ret.m_values.emplace_back(std::move(tensor.value()));
+      break;
+    }
+    default:
+      return {};
+    }
+  }
+
+  return ret;
+}
+
+//-----------------------------------------------------------------------------------------
+size_t ValueStore::Size() const { return m_values.size(); }
+
+//-----------------------------------------------------------------------------------------
+const TSetValue &ValueStore::Get(size_t slot_) const {
+  return m_values[slot_];
+}
+
+//-----------------------------------------------------------------------------------------
+void ValueStore::Set(size_t slot_, TSetValue value_) {
+  m_values[slot_] = std::move(value_);
+}
+
+//-----------------------------------------------------------------------------------------
+std::optional<TSetValue> ValueStore::Find(const Plan &plan_,
+                                          const Node::NName &name_) const {
+  auto slot = plan_.Slot(name_);
+  if (!slot.has_value() || slot.value() >= Size())
+    return {};
+
+  return m_values[slot.value()];
+}
+
+//-----------------------------------------------------------------------------------------
+std::vector<TSetValue> &ValueStore::Values() { return m_values; }
+
+//-----------------------------------------------------------------------------------------
+const std::vector<TSetValue> &ValueStore::Values() const { return m_values; }
+
+//-----------------------------------------------------------------------------------------
+std::size_t ValueStore::InputHash(const Plan &plan_) const {
+  std::vector<bool> written(plan_.slots.size());
+  for (const auto &hop : plan_.hops)
+    written[hop.target] = true;
+
+  std::size_t ret{};
+  for (size_t slot = 0; slot < written.size() && slot < Size(); ++slot) {
+    if (!written[slot]) {
+      hash_combine(ret, slot);
+      hash_combine(ret, std::hash<TSetValue>{}(m_values[slot]));
+    }
+  }
+
+  return ret;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "parser.h"
+
+namespace cat {
+//============================================================
+// Testing of shared internal mappings
+//============================================================
+void test_arrow_interning() {
+  size_t initial = Arrow::CountInterned();
+
+  {
+    auto src = R"(
+LCAT Cat
+{
+   SCAT A
+   {
+      OBJ a0, a1;
+   }
+
+   SCAT B
+   {
+      OBJ b0, b1;
+   }
+
+   A -[f]-> B
+   {
+      a0 -[*]-> b0 {};
+      a1 -[*]-> b1 {};
+   }
+
+   A -[g]-> B
+   {
+      a0 -[*]-> b0 {};
+      a1 -[*]-> b1 {};
+   }
+
+   A -[h]-> B
+   {
+      a0 -[*]-> b1 {};
+      a1 -[*]-> b1 {};
+   }
+}
+         )";
+
+    Parser prs;
+    prs.ParseSource(src);
+
+    Node ccat = *prs.Data();
+
+    // Identities of A and B, mappings of f (shared with g) and h
+    assert(Arrow::CountInterned() == initial + 4);
+
+    Arrow f = ccat.QueryArrows(Arrow("A", "B", "f").AsQuery()).front();
+    Arrow g = ccat.QueryArrows(Arrow("A", "B", "g").AsQuery()).front();
+    assert(f.IsAssociative(g));
+    assert(Arrow::CountInterned() == initial + 4);
+
+    // Modification detaches the copy from the pool
+    f.EraseArrows();
+    f.EmplaceArrow("a0", "b0");
+    f.EmplaceArrow("a1", "b0");
+    assert(f.CountArrows() == 2);
+    assert(!f.IsAssociative(g));
+    assert(g.QueryArrows(Arrow("a1", "b1", "*").AsQuery()).size() == 1);
+    assert(ccat.QueryArrows(Arrow("A", "B", "f").AsQuery())
+               .front()
+               .IsAssociative(g));
+
+    f.Intern();
+    assert(Arrow::CountInterned() == initial + 5);
+  }
+
+  assert(Arrow::CountInterned() == initial);
+}
+} // namespace cat
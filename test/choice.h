@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <stdexcept>
 
 #include "../include/node.h"
+#include "../include/thread_pool.h"
 #include "parser.h"
 
 namespace cat {
@@ -61,5 +63,39 @@ LCAT cat
   assert(detBC.QueryArrows(Arrow("a0", "b0", "*").AsQuery()).size() == 1);
   assert(detBC.QueryArrows(Arrow("a1", "b1", "*").AsQuery()).size() == 1);
   assert(detBC.QueryArrows(Arrow("a2", "b1", "*").AsQuery()).size() == 1);
+
+  // Parallel search
+  ThreadPool pool(4);
+
+  Arrow::List parallel =
+      cat.SolveChoice(Arrow::AName("B_C"), Arrow::AName("A_C"), pool);
+  assert(parallel == determ);
+
+  parallel = cat.SolveChoice(Arrow::AName("B_C"), Arrow::AName("A_C"), pool, 1);
+  assert(parallel == determ);
+
+  size_t streamed{};
+  parallel = cat.SolveChoice(Arrow::AName("B_C"), Arrow::AName("A_C"), pool,
+                             std::optional<size_t>(), [&](const Arrow &arrow_) {
+                               ++streamed;
+                               return arrow_.Source() != "A";
+                             });
+  assert(streamed == 1);
+  assert(parallel == determ);
+
+  assert(cat.SolveChoice(Arrow::AName("B_C"), Arrow::AName("A_C"), pool, 0)
+             .empty());
+
+  // Exception of callback reaches the caller after workers are done
+  bool thrown{};
+  try {
+    cat.SolveChoice(Arrow::AName("B_C"), Arrow::AName("A_C"), pool,
+                    std::optional<size_t>(), [](const Arrow &) -> bool {
+                      throw std::runtime_error("solution");
+                    });
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  assert(thrown);
 }
 } // namespace cat
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <assert.h>
+#include <functional>
+#include <string>
+
+#include "../include/node.h"
+#include "counters.h"
+#include "parser.h"
+
+namespace cat {
+//============================================================
+// Counts operations at sizes n, 2n and 4n, setup isn't counted
+//============================================================
+template <typename TState>
+std::array<uint64_t, 3>
+count_scaling(ECounter counter_, size_t n_,
+              const std::function<TState(size_t)> &setup_,
+              const std::function<void(TState &, size_t)> &fn_) {
+  std::array<uint64_t, 3> ret{};
+
+  for (size_t i = 0; i < ret.size(); ++i) {
+    size_t size = n_ << i;
+    TState state = setup_(size);
+
+    reset_counters();
+    fn_(state, size);
+    ret[i] = get_counter(counter_);
+  }
+
+  return ret;
+}
+
+//============================================================
+// Checks that doubling of size multiplies count at most by factor
+//============================================================
+bool grows_within(const std::array<uint64_t, 3> &counts_, double factor_) {
+  for (size_t i = 1; i < counts_.size(); ++i) {
+    if (!counts_[i - 1] || counts_[i] > factor_ * counts_[i - 1])
+      return false;
+  }
+
+  return true;
+}
+
+//============================================================
+// Testing of complexity by operation counters
+//============================================================
+void test_complexity() {
+  bool counting = get_counting();
+  set_counting(true);
+
+  auto fnName = [](size_t index_) { return "o" + std::to_string(index_); };
+
+  // o0 -> o1 -> ... -> on-1
+  auto fnChain = [&](size_t size_) {
+    Node ret("chain", Node::EType::eSCategory);
+
+    for (size_t i = 0; i < size_; ++i)
+      ret.AddNode(Node(fnName(i), Node::EType::eObject));
+
+    for (size_t i = 1; i < size_; ++i)
+      ret.AddArrow(Arrow(fnName(i - 1), fnName(i)));
+
+    return ret;
+  };
+
+  // Linear growth doubles, logarithmic factors are tolerated
+  const double linear = 2.5;
+
+  {
+    // Single arrow addition scans arrows once
+    auto counts = count_scaling<Node>(
+        ECounter::eArrowScans, 32, fnChain, [&](Node &node_, size_t size_) {
+          assert(node_.AddArrow(Arrow(fnName(0), fnName(size_ - 1))));
+        });
+
+    assert(grows_within(counts, linear));
+  }
+
+  {
+    // Building a chain allocates per object and arrow
+    auto counts = count_scaling<size_t>(
+        ECounter::eAllocations, 32, [](size_t size_) { return size_; },
+        [&](size_t &size_, size_t) { fnChain(size_); });
+
+    assert(grows_within(counts, linear));
+  }
+
+  {
+    // Verification of functor visits every mapped object
+    auto fnFunctor = [&](size_t size_) {
+      Node ret("lcat", Node::EType::eLCategory);
+
+      Node a = fnChain(size_);
+      a.SetName("A");
+      Node b = fnChain(size_);
+      b.SetName("B");
+
+      ret.AddNodes({a, b});
+
+      return ret;
+    };
+
+    auto counts = count_scaling<Node>(
+        ECounter::eArrowScans, 16, fnFunctor, [&](Node &node_, size_t size_) {
+          Arrow functor("A", "B");
+          for (size_t i = 0; i < size_; ++i)
+            functor.EmplaceArrow(fnName(i), fnName(i));
+
+          assert(node_.Verify(functor));
+        });
+
+    assert(grows_within(counts, linear));
+  }
+
+  {
+    // Parsing tokenizes every statement once
+    auto fnSource = [&](size_t size_) {
+      std::string ret = "SCAT chain\n{\n   OBJ ";
+      for (size_t i = 0; i < size_; ++i)
+        ret += (i ? ", " : "") + fnName(i);
+      ret += ";\n";
+
+      for (size_t i = 1; i < size_; ++i)
+        ret += "   " + fnName(i - 1) + " -[*]-> " + fnName(i) + " {};\n";
+
+      return ret + "}\n";
+    };
+
+    auto counts = count_scaling<std::string>(
+        ECounter::eTokenizerCalls, 8, fnSource, [](std::string &src_, size_t) {
+          Parser parser;
+          parser.ParseSource(src_);
+        });
+
+    assert(grows_within(counts, linear));
+  }
+
+  {
+    // Lookup of node compares logarithmic number of nodes
+    auto counts = count_scaling<Node>(
+        ECounter::eComparisons, 64, fnChain, [&](Node &node_, size_t size_) {
+          assert(node_.QueryNodes(fnName(size_ / 2)).size() == 1);
+        });
+
+    assert(grows_within(counts, 1.5));
+  }
+
+  reset_counters();
+  set_counting(counting);
+}
+} // namespace cat
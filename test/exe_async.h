@@ -0,0 +1,144 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of asynchronous functions
+//============================================================
+void test_exe_async() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(1);
+
+  Arrow ab("a", "b", "async_load");
+  Arrow bc("b", "c", "async_incr");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  // Slow lookup standing in for I/O
+  std::atomic<int> running{};
+  std::atomic<int> maxRunning{};
+
+  Register::Inst().RegAsync(ab, [&](const TSetValue &arg_) {
+    int arg = std::get<(int)ESetTypes::eInt>(arg_);
+
+    return std::async(std::launch::async, [&, arg]() -> TSetValue {
+      int now = ++running;
+      int max = maxRunning;
+      while (now > max && !maxRunning.compare_exchange_weak(max, now))
+        ;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      --running;
+
+      if (arg < 0)
+        throw std::runtime_error("negative key");
+
+      return arg * 100;
+    });
+  });
+  Register::Inst().Reg<int, int>(bc, [](int arg_) { return arg_ + 1; });
+
+  assert(Register::Inst().GetAsync(ab));
+  assert(!Register::Inst().GetAsync(bc));
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+  assert(plan->hops.front().async);
+
+  // Asynchronous functions are not fused
+  assert(Executor::Inst().Compile(cat, {})->hops.size() == 2);
+
+  // Synchronous run waits for the result
+  assert(Executor::Inst().Run(plan.value(), cat));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(101));
+
+  std::vector<Executor::TRecord> records;
+  auto slotA = plan->Slot("a").value();
+  auto slotC = plan->Slot("c").value();
+
+  for (int i = 0; i < 8; ++i) {
+    Executor::TRecord record(plan->slots.size(), 0);
+    record[slotA] = i == 5 ? -1 : i;
+    records.push_back(record);
+  }
+  records.push_back({});
+
+  maxRunning = 0;
+  auto ret = Executor::Inst().RunAsync(plan.value(), records, 4);
+  assert(ret.size() == records.size());
+
+  for (int i = 0; i < 8; ++i) {
+    if (i == 5) {
+      assert(!ret[i].has_value());
+      continue;
+    }
+
+    assert(ret[i]->at(slotC) == TSetValue(i * 100 + 1));
+  }
+
+  // Record not fitting the plan fails
+  assert(!ret.back().has_value());
+
+  // Pending lookups overlapped, bounded by the number of runs in flight
+  assert(maxRunning > 1 && maxRunning <= 4);
+
+  // Throwing functions and missing futures fail only their records
+  Register::Inst().RegAsync(ab, [](const TSetValue &arg_) {
+    int arg = std::get<(int)ESetTypes::eInt>(arg_);
+    if (arg < 0)
+      throw std::runtime_error("negative key");
+
+    if (arg == 0)
+      return std::future<TSetValue>();
+
+    std::promise<TSetValue> promise;
+    promise.set_value(arg * 100);
+    return promise.get_future();
+  });
+  Register::Inst().Reg<int, int>(bc, [](int arg_) {
+    if (arg_ == 300)
+      throw std::runtime_error("bad value");
+    return arg_ + 1;
+  });
+
+  plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+
+  records.clear();
+  for (int key : {-1, 0, 3, 2}) {
+    Executor::TRecord record(plan->slots.size(), 0);
+    record[slotA] = key;
+    records.push_back(record);
+  }
+
+  ret = Executor::Inst().RunAsync(plan.value(), records, 2);
+  assert(!ret[0].has_value());
+  assert(!ret[1].has_value());
+  assert(!ret[2].has_value());
+  assert(ret[3]->at(slotC) == TSetValue(201));
+
+  Register::Inst().Reg(ab, [](TSetValue val) { return val; });
+  assert(!Register::Inst().GetAsync(ab));
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+}
+} // namespace cat
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "batch.h"
+#include "executor.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of batch execution
+//============================================================
+void test_exe_batch() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(0);
+
+  Arrow ab("a", "b", "batch_incr");
+  Arrow bc("b", "c", "batch_mlt");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  Register::Inst().Reg(ab, [](TSetValue val) {
+    return std::get<(int)ESetTypes::eInt>(val) + 4;
+  });
+  Register::Inst().Reg(bc, [](TSetValue val) {
+    return std::get<(int)ESetTypes::eInt>(val) * 2;
+  });
+
+  int kernelCalls{};
+  Register::Inst().RegBatch<int, int>(
+      ab, [&](Span<const int> args_, Span<int> rets_) {
+        ++kernelCalls;
+        for (size_t i = 0; i < args_.size(); ++i)
+          rets_[i] = args_[i] + 4;
+      });
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+
+  Executor::TBatch inputs;
+  inputs["a"] = std::vector<int>{1, 2, 3, 4};
+
+  // Kernel for the first arrow, registered function for the second one
+  auto ret = Executor::Inst().RunBatch(plan.value(), cat, inputs);
+  assert(ret.has_value());
+  assert(kernelCalls == 1);
+  assert(std::get<std::vector<int>>(ret->at("b")) ==
+         std::vector<int>({5, 6, 7, 8}));
+  assert(std::get<std::vector<int>>(ret->at("c")) ==
+         std::vector<int>({10, 12, 14, 16}));
+
+  // Batch and scalar runs agree
+  for (int value : {1, 2, 3, 4}) {
+    Node single = cat;
+    single.SetNodeValue("a", value);
+    assert(Executor::Inst().Run(plan.value(), single));
+
+    auto control =
+        std::get<(int)ESetTypes::eInt>(single.FindNode("c")->GetValue());
+    assert(control == (value + 4) * 2);
+  }
+
+  // Kernel doesn't accept the column type, values go one by one
+  Register::Inst().RegBatch<double, double>(
+      bc, [](Span<const double> args_, Span<double> rets_) {
+        for (size_t i = 0; i < args_.size(); ++i)
+          rets_[i] = args_[i] * 2;
+      });
+
+  plan = Executor::Inst().Compile(cat);
+  ret = Executor::Inst().RunBatch(plan.value(), cat, inputs);
+  assert(ret.has_value());
+  assert(std::get<std::vector<int>>(ret->at("c")) ==
+         std::vector<int>({10, 12, 14, 16}));
+
+  // Input columns of different sizes
+  inputs["b"] = std::vector<int>{1};
+  assert(!Executor::Inst().RunBatch(plan.value(), cat, inputs).has_value());
+
+  // Columns and values
+  auto column = make_column({TSetValue(1.5), TSetValue(2.5)});
+  assert(column.has_value() && column_size(column.value()) == 2);
+  assert(column_value(column.value(), 1) == TSetValue(2.5));
+  assert(!make_column({TSetValue(1.5), TSetValue(2)}).has_value());
+  assert(column_size(make_column(TSetValue(std::string("s")), 3)) == 3);
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+  assert(!Register::Inst().GetBatch(ab));
+}
+} // namespace cat
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <assert.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "../include/node.h"
+#include "checkpoint.h"
+#include "execution_context.h"
+
+namespace cat {
+//============================================================
+// Testing of checkpointed runs
+//============================================================
+void test_exe_checkpoint() {
+  {
+    // Values of all types survive writing
+    ValueStore store(5);
+    store.Set(0, 1.5);
+    store.Set(1, 2.5f);
+    store.Set(2, -7);
+    store.Set(3, std::string("text"));
+
+    auto tensor = Tensor::Create({1, 2, 3, 4, 5, 6}, {2, 3});
+    store.Set(4, tensor->Slice(1, 2).value());
+
+    std::stringstream stream;
+    assert(store.Write(stream));
+
+    auto read = ValueStore::Read(stream);
+    assert(read.has_value());
+    assert(read->Values() == store.Values());
+
+    std::stringstream truncated(stream.str().substr(0, 20));
+    assert(!ValueStore::Read(truncated).has_value());
+  }
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "cat_exe_checkpoint.ckpt")
+          .string();
+  Checkpoint::Remove(path);
+
+  ExecutionContext context(1);
+
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+  Node d("d", Node::EType::eObject);
+
+  a.SetValue(1);
+
+  Arrow ab("a", "b", "ckpt_ab");
+  Arrow bc("b", "c", "ckpt_bc");
+  Arrow cd("c", "d", "ckpt_cd");
+
+  cat.AddNodes({a, b, c, d});
+  cat.AddArrows({ab, bc, cd});
+
+  cat.SolveCompositions();
+  cat.SolveCompositions();
+
+  int calls{};
+  bool preempted{true};
+
+  context.GetRegister().Reg<int, int>(ab, [&](int arg_) {
+    ++calls;
+    return arg_ + 1;
+  });
+  context.GetRegister().Reg<int, int>(bc, [&](int arg_) {
+    ++calls;
+    return arg_ * 10;
+  });
+  context.GetRegister().Reg<int, int>(cd, [&](int arg_) {
+    ++calls;
+    if (preempted)
+      throw std::runtime_error("preempted");
+    return arg_ + 5;
+  });
+
+  Executor &executor = context.GetExecutor();
+
+  auto plan = executor.Compile(cat);
+  assert(plan.has_value());
+  assert(plan->hops.size() == 3);
+
+  // Run breaks on the last hop, progress is saved
+  try {
+    executor.Run(plan.value(), cat, path, 1);
+    assert(false);
+  } catch (const std::runtime_error &) {
+  }
+
+  assert(calls == 3);
+  assert(std::filesystem::exists(path));
+
+  auto checkpoint = Checkpoint::Load(path);
+  assert(checkpoint.has_value());
+  assert(checkpoint->Cursor() == 2);
+  assert(checkpoint->Store().Find(plan.value(), "c") == TSetValue(20));
+
+  // Resumed run does only the rest of hops
+  preempted = false;
+  calls = 0;
+  assert(executor.Run(plan.value(), cat, path, 1));
+  assert(calls == 1);
+  assert(cat.FindNode("d")->GetValue() == TSetValue(25));
+  assert(!std::filesystem::exists(path));
+
+  // Checkpoint of another run is ignored
+  ValueStore store(plan->slots.size());
+  assert(Checkpoint::Save(path, 0, 2, store));
+
+  calls = 0;
+  assert(executor.Run(plan.value(), cat, path, 1));
+  assert(calls == 3);
+  assert(cat.FindNode("d")->GetValue() == TSetValue(25));
+
+  std::ofstream(path) << "garbage";
+  assert(!Checkpoint::Load(path).has_value());
+  assert(executor.Run(plan.value(), cat, path, 2));
+  assert(!std::filesystem::exists(path));
+
+  // Checkpoint of other input values is ignored
+  preempted = true;
+  try {
+    executor.Run(plan.value(), cat, path, 1);
+    assert(false);
+  } catch (const std::runtime_error &) {
+  }
+  assert(std::filesystem::exists(path));
+
+  preempted = false;
+  cat.SetNodeValue("a", 2);
+  calls = 0;
+  assert(executor.Run(plan.value(), cat, path, 1));
+  assert(calls == 3);
+  assert(cat.FindNode("d")->GetValue() == TSetValue(35));
+
+  // Run fails if progress can't be saved
+  const std::string missing =
+      (std::filesystem::temp_directory_path() / "cat_missing" / "run.ckpt")
+          .string();
+  assert(!executor.Run(plan.value(), cat, missing, 1));
+  Checkpoint::Remove(path);
+}
+} // namespace cat
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <assert.h>
+#include <thread>
+
+#include "../include/node.h"
+#include "execution_context.h"
+
+namespace cat {
+//============================================================
+// Testing of execution contexts
+//============================================================
+void test_exe_context() {
+  assert(&ExecutionContext::Default().GetRegister() == &Register::Inst());
+  assert(&ExecutionContext::Default().GetExecutor() == &Executor::Inst());
+  assert(&ExecutionContext::Default().GetPool() == &ThreadPool::Inst());
+
+  auto fnMakeCat = []() {
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    Node b("b", Node::EType::eObject);
+
+    a.SetValue(5);
+
+    cat.AddNodes({a, b});
+    cat.AddArrow(Arrow("a", "b", "ctx_fn"));
+
+    cat.SolveCompositions();
+    return cat;
+  };
+
+  Arrow ab("a", "b", "ctx_fn");
+
+  ExecutionContext first(2);
+  ExecutionContext second(2);
+
+  // Same arrow, different functions per context
+  first.GetRegister().Reg<int, int>(ab, [](int arg_) { return arg_ + 1; });
+  second.GetRegister().Reg<int, int>(ab, [](int arg_) { return arg_ * 10; });
+
+  assert(!Register::Inst().GetSignature(ab).has_value());
+  assert(&first.GetExecutor().GetRegister() == &first.GetRegister());
+
+  // Contexts run concurrently without sharing anything
+  std::thread worker([&]() {
+    for (int i = 0; i < 100; ++i) {
+      Node cat = fnMakeCat();
+      assert(second.Exec(cat));
+      assert(cat.FindNode("b")->GetValue() == TSetValue(50));
+    }
+  });
+
+  for (int i = 0; i < 100; ++i) {
+    Node cat = fnMakeCat();
+    assert(first.Exec(cat));
+    assert(cat.FindNode("b")->GetValue() == TSetValue(6));
+  }
+
+  worker.join();
+
+  Node cat = fnMakeCat();
+  assert(first.ExecParallel(cat));
+  assert(cat.FindNode("b")->GetValue() == TSetValue(6));
+
+  // Default context doesn't know the function
+  cat = fnMakeCat();
+  assert(ExecutionContext::Default().Exec(cat));
+  assert(cat.FindNode("b")->GetValue() == TSetValue(5));
+
+  // Mapping with register of context
+  Node a("a", Node::EType::eObject);
+  a.SetValue(2);
+  assert(ab.Map(a, second.GetRegister())->GetValue() == TSetValue(20));
+
+  cat = fnMakeCat();
+  cat.SetNodeValue("a", 1.5);
+  assert(!first.Exec(cat));
+
+  ExecutionContext::Stats stats = first.GetStats();
+  assert(stats.execs == 102);
+  assert(stats.failures == 1);
+  assert(second.GetStats().execs == 100);
+}
+} // namespace cat
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "register.h"
+#include "thread_pool.h"
+
+namespace cat {
+//============================================================
+// Testing of fusion of function chains
+//============================================================
+void test_exe_fusion() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+  Node d("d", Node::EType::eObject);
+
+  a.SetValue(1);
+  b.SetValue(0);
+  c.SetValue(0);
+
+  Arrow ab("a", "b", "fuse_incr");
+  Arrow bc("b", "c", "fuse_mlt");
+  Arrow cd("c", "d", "fuse_neg");
+
+  cat.AddNodes({a, b, c, d});
+  cat.AddArrows({ab, bc, cd});
+
+  cat.SolveCompositions();
+  cat.SolveCompositions();
+
+  int calls{};
+  Register::Inst().Reg<int, int>(ab, [&](int arg_) {
+    ++calls;
+    return arg_ + 1;
+  });
+  Register::Inst().Reg(bc, [&](TSetValue val) {
+    ++calls;
+    return std::get<(int)ESetTypes::eInt>(val) * 10;
+  });
+  Register::Inst().Reg<int, int>(cd, [&](int arg_) {
+    ++calls;
+    return -arg_;
+  });
+
+  auto full = Executor::Inst().Compile(cat);
+  assert(full.has_value());
+  assert(full->hops.size() == 3);
+
+  // Whole chain is one hop, intermediate nodes are not written
+  auto fused = Executor::Inst().Compile(cat, {});
+  assert(fused.has_value());
+  assert(fused->hops.size() == 1);
+  assert(fused->hops.front().invoker);
+  assert(!fused->hops.front().batch);
+
+  assert(Executor::Inst().Run(fused.value(), cat));
+  assert(calls == 3);
+  assert(cat.FindNode("d")->GetValue() == TSetValue(-20));
+  assert(cat.FindNode("b")->GetValue() == TSetValue(0));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(0));
+
+  // Requested intermediate node splits the chain
+  auto partial = Executor::Inst().Compile(cat, {"c"});
+  assert(partial.has_value());
+  assert(partial->hops.size() == 2);
+
+  assert(Executor::Inst().Run(partial.value(), cat));
+  assert(cat.FindNode("b")->GetValue() == TSetValue(0));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(20));
+  assert(cat.FindNode("d")->GetValue() == TSetValue(-20));
+
+  // Fused plans run the same way in other modes
+  ThreadPool pool(2);
+  cat.SetNodeValue("a", 2);
+  assert(Executor::Inst().Run(fused.value(), cat, pool));
+  assert(cat.FindNode("d")->GetValue() == TSetValue(-30));
+
+  Executor::TBatch inputs;
+  inputs["a"] = std::vector<int>{0, 1};
+  auto ret = Executor::Inst().RunBatch(fused.value(), cat, inputs);
+  assert(ret.has_value());
+  assert(std::get<std::vector<int>>(ret->at("d")) ==
+         std::vector<int>({-10, -20}));
+
+  // Fused typed functions keep batch kernels
+  Register::Inst().Reg<int, int>(bc, [](int arg_) { return arg_ * 10; });
+  fused = Executor::Inst().Compile(cat, {});
+  assert(fused->hops.front().batch);
+
+  ret = Executor::Inst().RunBatch(fused.value(), cat, inputs);
+  assert(std::get<std::vector<int>>(ret->at("d")) ==
+         std::vector<int>({-10, -20}));
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+  Register::Inst().Unreg(cd);
+}
+} // namespace cat
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+
+#include "../include/node.h"
+#include "execution_context.h"
+
+namespace cat {
+//============================================================
+// Testing of hierarchical execution
+//============================================================
+void test_exe_hierarchy() {
+  ExecutionContext context(4);
+  Register &reg = context.GetRegister();
+
+  {
+    // Functor maps every sample to a result
+    const int count = 100;
+
+    Node samples("Samples", Node::EType::eSCategory);
+    Node results("Results", Node::EType::eSCategory);
+
+    Arrow functor("Samples", "Results", "h_double");
+
+    for (int i = 0; i < count; ++i) {
+      Node sample("s" + std::to_string(i), Node::EType::eObject);
+      sample.SetValue(i);
+
+      samples.AddNode(sample);
+      results.AddNode(Node("r" + std::to_string(i), Node::EType::eObject));
+
+      functor.EmplaceArrow("s" + std::to_string(i), "r" + std::to_string(i));
+    }
+
+    samples.SetValue(count);
+
+    Node cat("cat", Node::EType::eLCategory);
+    cat.AddNodes({samples, results});
+    assert(cat.AddArrow(functor));
+
+    cat.SolveCompositions();
+
+    std::atomic<int> calls{};
+    reg.Reg<int, int>(functor, [&](int arg_) {
+      ++calls;
+      return arg_ * 2;
+    });
+
+    // Object mapping with its own function
+    reg.Reg<int, int>(Arrow("s0", "r0"), [](int) { return -1; });
+
+    assert(context.ExecHierarchy(cat));
+
+    // Function of functor maps the category value and the rest of objects
+    assert(calls == count);
+
+    const Node *target = cat.FindNode("Results");
+    assert(target->GetValue() == TSetValue(2 * count));
+    assert(target->FindNode("r0")->GetValue() == TSetValue(-1));
+
+    for (int i = 1; i < count; ++i) {
+      assert(target->FindNode("r" + std::to_string(i))->GetValue() ==
+             TSetValue(2 * i));
+    }
+
+    // Functors mapping objects which don't exist are refused upfront
+    Arrow broken("Samples", "Results", "h_broken");
+    broken.EmplaceArrow("s0", "nobody");
+    assert(!cat.AddArrow(broken));
+  }
+
+  {
+    // Both levels: People { p -> rank }, Aliens { a -> score },
+    // People -[isSuperior]-> Aliens maps p to a and rank to score
+    Node people("People", Node::EType::eSCategory);
+    Node aliens("Aliens", Node::EType::eSCategory);
+
+    Node p("p", Node::EType::eObject);
+    p.SetValue(3);
+
+    Arrow rank("p", "rank", "h_rank");
+    Arrow score("a", "score", "h_score");
+
+    people.AddNodes({p, Node("rank", Node::EType::eObject)});
+    people.AddArrow(rank);
+    people.SolveCompositions();
+
+    aliens.AddNodes({Node("a", Node::EType::eObject),
+                     Node("score", Node::EType::eObject)});
+    aliens.AddArrow(score);
+    aliens.SolveCompositions();
+
+    Arrow isSuperior("People", "Aliens", "isSuperior");
+    isSuperior.EmplaceArrow("p", "a");
+    isSuperior.EmplaceArrow("rank", "score");
+
+    Node cat("cat", Node::EType::eLCategory);
+    cat.AddNodes({people, aliens});
+    assert(cat.AddArrow(isSuperior));
+
+    cat.SolveCompositions();
+
+    reg.Reg<int, int>(rank, [](int arg_) { return arg_ * 10; });
+    reg.Reg<int, int>(score, [](int arg_) { return arg_ + 1; });
+
+    assert(context.ExecHierarchy(cat));
+    assert(cat.FindNode("People")->FindNode("rank")->GetValue() ==
+           TSetValue(30));
+
+    // Target category is executed after mapping
+    assert(cat.FindNode("Aliens")->FindNode("a")->GetValue() == TSetValue(3));
+    assert(cat.FindNode("Aliens")->FindNode("score")->GetValue() ==
+           TSetValue(4));
+
+    // Changed object propagates through both levels
+    cat.UpdateNode("People",
+                   [](Node &people_) { people_.SetNodeValue("p", 7); });
+
+    assert(context.ExecHierarchy(cat));
+    assert(cat.FindNode("Aliens")->FindNode("score")->GetValue() ==
+           TSetValue(8));
+  }
+}
+} // namespace cat
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of incremental execution
+//============================================================
+void test_exe_incremental() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+  Node d("d", Node::EType::eObject);
+
+  a.SetValue(10);
+
+  Arrow ab("a", "b", "inc_half");
+  Arrow bc("b", "c", "inc_incr");
+  Arrow cd("c", "d", "inc_mlt");
+
+  cat.AddNodes({a, b, c, d});
+  cat.AddArrows({ab, bc, cd});
+
+  cat.SolveCompositions();
+  cat.SolveCompositions();
+
+  int calls{};
+  Register::Inst().Reg<int, int>(ab, [&](int arg_) {
+    ++calls;
+    return arg_ / 2;
+  });
+  Register::Inst().Reg<int, int>(bc, [&](int arg_) {
+    ++calls;
+    return arg_ + 1;
+  });
+  Register::Inst().Reg<int, int>(cd, [&](int arg_) {
+    ++calls;
+    return arg_ * 3;
+  });
+
+  // Value versions
+  Node x("x", Node::EType::eObject);
+  assert(x.Version() == 0);
+  x.SetValue(1);
+  Node y = x;
+  assert(y.Version() == x.Version());
+  y.SetValue(1);
+  assert(y.Version() > x.Version());
+
+  auto fnValue = [&](const Node::NName &name_) {
+    return std::get<(int)ESetTypes::eInt>(cat.FindNode(name_)->GetValue());
+  };
+
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 3);
+  assert(fnValue("d") == 18);
+
+  // Nothing changed
+  calls = 0;
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 0);
+
+  // Change propagates downstream
+  cat.SetNodeValue("a", 20);
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 3);
+  assert(fnValue("d") == 33);
+
+  // Unchanged intermediate result stops propagation
+  calls = 0;
+  cat.SetNodeValue("a", 21);
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 1);
+  assert(fnValue("d") == 33);
+
+  // Overwritten intermediate node is restored
+  calls = 0;
+  cat.SetNodeValue("b", 100);
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 2);
+  assert(fnValue("b") == 10);
+  assert(fnValue("d") == 33);
+
+  // Copy with the same values needs no work
+  calls = 0;
+  Node copy = cat;
+  assert(Executor::Inst().Exec(copy));
+  assert(calls == 0);
+
+  // Registration invalidates cached plans
+  Register::Inst().Reg<int, int>(cd, [&](int arg_) {
+    ++calls;
+    return arg_ * 4;
+  });
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 3);
+  assert(fnValue("d") == 44);
+
+  Executor::Inst().ResetCache();
+  calls = 0;
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 3);
+
+  // Same names with other arrows are another structure
+  Node other = cat;
+  assert(other.SameStructure(cat));
+  other.EraseArrow("inc_mlt");
+  other.AddArrow(Arrow("c", "d", "inc_other"));
+  assert(!other.SameStructure(cat));
+
+  // The least recently used plan is dropped, the structure is compiled again
+  Executor::Inst().SetCacheCapacity(1);
+  assert(Executor::Inst().Exec(other));
+  calls = 0;
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 3);
+
+  calls = 0;
+  assert(Executor::Inst().Exec(cat));
+  assert(calls == 0);
+
+  Executor::Inst().SetCacheCapacity(64);
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+  Register::Inst().Unreg(cd);
+}
+} // namespace cat
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "register.h"
+#include "thread_pool.h"
+
+namespace cat {
+//============================================================
+// Testing of parallel execution
+//============================================================
+void test_exe_parallel() {
+  ThreadPool pool(4);
+
+  {
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    Node b("b", Node::EType::eObject);
+    Node c("c", Node::EType::eObject);
+
+    a.SetValue(2);
+
+    Arrow ab("a", "b", "par_incr");
+    Arrow bc("b", "c", "par_mlt");
+
+    cat.AddNodes({a, b, c});
+    cat.AddArrows({ab, bc});
+
+    cat.SolveCompositions();
+
+    Register::Inst().Reg(ab, [](TSetValue val) {
+      return std::get<(int)ESetTypes::eInt>(val) + 4;
+    });
+    Register::Inst().Reg(bc, [](TSetValue val) {
+      return std::get<(int)ESetTypes::eInt>(val) * 2;
+    });
+
+    assert(Executor::Inst().Exec(cat, pool));
+
+    auto control =
+        std::get<(int)ESetTypes::eInt>(cat.FindNode("c")->GetValue());
+    assert(control == 12);
+
+    Register::Inst().Unreg(ab);
+    Register::Inst().Unreg(bc);
+  }
+
+  {
+    // Exception of function fails the run instead of blocking it
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    Node b("b", Node::EType::eObject);
+
+    a.SetValue(1);
+
+    Arrow ab("a", "b", "par_throw");
+
+    cat.AddNodes({a, b});
+    cat.AddArrow(ab);
+
+    Register::Inst().Reg(ab, [](TSetValue) -> TSetValue {
+      throw std::runtime_error("par_throw");
+    });
+
+    assert(!Executor::Inst().Exec(cat, pool));
+
+    Register::Inst().Unreg(ab);
+  }
+
+  {
+    // Wide fan-out from the root with a merge at the end:
+    // root -> x_i -> y_i, y_i -> sink in the order of branches
+    const int branches = 16;
+
+    Node cat("cat", Node::EType::eSCategory);
+    Plan plan;
+
+    auto fnAddNode = [&](const Node::NName &name_, int value_) {
+      Node node(name_, Node::EType::eObject);
+      node.SetValue(value_);
+      cat.AddNode(node);
+      plan.slots.push_back(name_);
+      return plan.slots.size() - 1;
+    };
+
+    auto fnHop = [&](size_t source_, size_t target_, Register::TFn fn_) {
+      plan.hops.push_back({source_, target_,
+                           Arrow(plan.slots[source_], plan.slots[target_]),
+                           std::move(fn_), false});
+    };
+
+    size_t root = fnAddNode("root", 1);
+    size_t sink = fnAddNode("sink", 0);
+
+    for (int i = 0; i < branches; ++i) {
+      size_t x = fnAddNode("x" + std::to_string(i), 0);
+      size_t y = fnAddNode("y" + std::to_string(i), 0);
+
+      fnHop(root, x, [i](TSetValue val) {
+        return std::get<(int)ESetTypes::eInt>(val) + i;
+      });
+      fnHop(x, y, [](TSetValue val) {
+        return std::get<(int)ESetTypes::eInt>(val) * 10;
+      });
+    }
+
+    // Sink is written by every branch, the last one wins as in a serial run
+    for (int i = 0; i < branches; ++i) {
+      size_t y = plan.Slot("y" + std::to_string(i)).value();
+      fnHop(y, sink, [](TSetValue val) {
+        return std::get<(int)ESetTypes::eInt>(val) + 1;
+      });
+    }
+
+    Node serial = cat;
+    assert(Executor::Inst().Run(plan, serial));
+
+    for (int round = 0; round < 20; ++round) {
+      Node parallel = cat;
+      assert(Executor::Inst().Run(plan, parallel, pool));
+
+      for (const auto &name : plan.slots) {
+        assert(parallel.FindNode(name)->GetValue() ==
+               serial.FindNode(name)->GetValue());
+      }
+    }
+
+    auto control =
+        std::get<(int)ESetTypes::eInt>(serial.FindNode("sink")->GetValue());
+    assert(control == (1 + branches - 1) * 10 + 1);
+  }
+
+  {
+    // Tasks submitted from the workers are stolen by idle ones
+    std::atomic<int> done{};
+    for (int i = 0; i < 8; ++i) {
+      pool.Submit([&]() {
+        for (int j = 0; j < 8; ++j)
+          pool.Submit([&]() { ++done; });
+      });
+    }
+
+    while (done < 64) {
+      if (!pool.RunPending())
+        std::this_thread::yield();
+    }
+  }
+
+  {
+    // Task throwing a non standard exception leaves the worker alive
+    std::atomic<int> done{};
+    for (size_t i = 0; i < pool.Size(); ++i)
+      pool.Submit([]() { throw 42; });
+    for (int i = 0; i < 8; ++i)
+      pool.Submit([&]() { ++done; });
+
+    while (done < 8) {
+      if (!pool.RunPending())
+        std::this_thread::yield();
+    }
+  }
+
+  {
+    // Failed call is rethrown to the caller once all calls are done
+    std::atomic<int> calls{};
+    bool thrown = false;
+    try {
+      pool.ForEach(16, [&](size_t index_) {
+        ++calls;
+        if (index_ == 5)
+          throw 42;
+      });
+    } catch (int error_) {
+      thrown = error_ == 42;
+    }
+
+    assert(thrown);
+    assert(calls == 16);
+  }
+}
+} // namespace cat
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "pipeline.h"
+#include "queue.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of streaming pipeline
+//============================================================
+void test_pipeline() {
+  {
+    SpscQueue<int> queue(3);
+    assert(queue.Capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+      assert(queue.TryPush(i));
+
+    int value = 4;
+    assert(!queue.TryPush(value));
+
+    for (int i = 0; i < 4; ++i) {
+      assert(queue.TryPop(value));
+      assert(value == i);
+    }
+    assert(!queue.TryPop(value));
+  }
+
+  {
+    // Concurrent producers and consumers see every value once
+    MpmcQueue<int> queue(16);
+    const int count = 20000;
+
+    std::atomic<long long> sum{};
+    std::atomic<int> popped{};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < 2; ++p) {
+      threads.emplace_back([&, p]() {
+        for (int i = p; i < count; i += 2) {
+          int value = i;
+          while (!queue.TryPush(value))
+            std::this_thread::yield();
+        }
+      });
+    }
+
+    for (int c = 0; c < 2; ++c) {
+      threads.emplace_back([&]() {
+        int value;
+        while (popped < count) {
+          if (queue.TryPop(value)) {
+            sum += value;
+            ++popped;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    assert(sum == (long long)count * (count - 1) / 2);
+  }
+
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(0);
+
+  Arrow ab("a", "b", "pipe_incr");
+  Arrow bc("b", "c", "pipe_mlt");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  Register::Inst().Reg<int, int>(ab, [](int arg_) { return arg_ + 1; });
+  Register::Inst().Reg<int, int>(bc, [](int arg_) { return arg_ * 2; });
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+
+  {
+    // Small queues make stages wait for each other
+    auto pipeline = Pipeline::Create(plan.value(), 4);
+    assert(pipeline);
+    assert(pipeline->Stages() == 2);
+
+    const int count = 5000;
+    auto slotA = plan->Slot("a").value();
+    auto slotC = plan->Slot("c").value();
+
+    std::thread producer([&]() {
+      auto record = pipeline->MakeRecord(cat).value();
+      for (int i = 0; i < count; ++i) {
+        record[slotA] = i;
+        assert(pipeline->Push(record));
+      }
+
+      // Record of other type is dropped
+      record[slotA] = 1.5;
+      assert(pipeline->Push(record));
+
+      pipeline->Close();
+    });
+
+    int expected = 0;
+    while (auto record = pipeline->Pop()) {
+      assert(record->at(slotC) == TSetValue((expected + 1) * 2));
+      ++expected;
+    }
+
+    producer.join();
+
+    assert(expected == count);
+    assert(pipeline->Dropped() == 1);
+    assert(!pipeline->Push(pipeline->MakeRecord(cat).value()));
+  }
+
+  {
+    // Closed pipeline with records in flight is destroyed
+    auto pipeline = Pipeline::Create(plan.value(), 2);
+    for (int i = 0; i < 2; ++i)
+      pipeline->Push(pipeline->MakeRecord(cat).value());
+  }
+
+  // Records must fit the plan
+  assert(!Pipeline::Create(plan.value())->Push({}));
+
+  Plan structural = plan.value();
+  structural.hops.front().structural = true;
+  assert(!Pipeline::Create(structural));
+  assert(!Pipeline::Create(Plan()));
+
+  {
+    // Throwing function drops its record, the stage keeps running
+    Register::Inst().Reg<int, int>(bc, [](int arg_) {
+      if (arg_ == 4)
+        throw std::runtime_error("pipe_mlt");
+      return arg_ * 2;
+    });
+
+    auto throwing = Executor::Inst().Compile(cat);
+    assert(throwing.has_value());
+
+    auto pipeline = Pipeline::Create(throwing.value());
+    auto slotA = throwing->Slot("a").value();
+
+    auto record = pipeline->MakeRecord(cat).value();
+    for (int i = 0; i < 6; ++i) {
+      record[slotA] = i;
+      assert(pipeline->Push(record));
+    }
+    pipeline->Close();
+
+    int popped{};
+    while (pipeline->Pop())
+      ++popped;
+
+    assert(popped == 5);
+    assert(pipeline->Dropped() == 1);
+  }
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+}
+} // namespace cat
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "parser.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of compiled execution plans
+//============================================================
+void test_exe_plan() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(3);
+
+  Arrow ab("a", "b", "plan_incr");
+  Arrow bc("b", "c", "plan_mlt");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  Register::Inst().Reg(ab, [](TSetValue val) {
+    return std::get<(int)ESetTypes::eInt>(val) + 1;
+  });
+  Register::Inst().Reg(bc, [](TSetValue val) {
+    return std::get<(int)ESetTypes::eInt>(val) * 3;
+  });
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+  assert(plan->slots.size() == 3);
+  assert(plan->hops.size() == 2);
+  assert(!plan->hops.front().structural);
+  assert(plan->Slot("a") == 0);
+  assert(!plan->Slot("d").has_value());
+
+  auto fnValue = [](const Node &node_, const Node::NName &name_) {
+    return std::get<(int)ESetTypes::eInt>(node_.FindNode(name_)->GetValue());
+  };
+
+  auto arrowCount = cat.QueryArrows(Arrow("*", "*").AsQuery()).size();
+
+  assert(Executor::Inst().Run(plan.value(), cat));
+  assert(fnValue(cat, "b") == 4);
+  assert(fnValue(cat, "c") == 12);
+
+  // The plan is reused for new input values
+  cat.SetNodeValue("a", 5);
+  assert(Executor::Inst().Run(plan.value(), cat));
+  assert(fnValue(cat, "c") == 18);
+
+  // Structure of the node is kept
+  assert(cat.QueryArrows(Arrow("*", "*").AsQuery()).size() == arrowCount);
+
+  // Missing node
+  Node other("other", Node::EType::eSCategory);
+  assert(!Executor::Inst().Run(plan.value(), other));
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+}
+} // namespace cat
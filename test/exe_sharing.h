@@ -0,0 +1,109 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "execution_context.h"
+
+namespace cat {
+//============================================================
+// Testing of sharing of chain prefixes
+//============================================================
+void test_exe_sharing() {
+  ExecutionContext context(2);
+  Register &reg = context.GetRegister();
+
+  {
+    // a -> b -> c -> {d, e}, terminals d and e are isomorphic
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    Node b("b", Node::EType::eObject);
+    Node c("c", Node::EType::eObject);
+    Node d("d", Node::EType::eObject);
+    Node e("e", Node::EType::eObject);
+
+    a.SetValue(1);
+
+    Arrow ab("a", "b", "share_ab");
+    Arrow bc("b", "c", "share_bc");
+    Arrow cd("c", "d", "share_cd");
+    Arrow ce("c", "e", "share_ce");
+    Arrow de("d", "e", "share_de");
+    Arrow ed("e", "d", "share_ed");
+
+    cat.AddNodes({a, b, c, d, e});
+    cat.AddArrows({ab, bc, cd, ce, de, ed});
+
+    cat.SolveCompositions();
+    cat.SolveCompositions();
+
+    int calls{};
+    reg.Reg<int, int>(ab, [&](int arg_) {
+      ++calls;
+      return arg_ + 1;
+    });
+    reg.Reg<int, int>(bc, [&](int arg_) {
+      ++calls;
+      return arg_ * 10;
+    });
+    reg.Reg<int, int>(cd, [](int arg_) { return arg_ + 1; });
+    reg.Reg<int, int>(ce, [](int arg_) { return arg_ + 2; });
+    reg.Reg<int, int>(de, [](int arg_) { return arg_ + 10; });
+    reg.Reg<int, int>(ed, [](int arg_) { return arg_ - 10; });
+
+    // Shared prefix is evaluated once for both terminals
+    auto plan = context.GetExecutor().Compile(cat);
+    assert(plan.has_value());
+    assert(plan->hops.size() == 4);
+
+    assert(context.Exec(cat));
+    assert(calls == 2);
+    assert(cat.FindNode("d")->GetValue() == TSetValue(21));
+    assert(cat.FindNode("e")->GetValue() == TSetValue(31));
+
+    calls = 0;
+    assert(context.ExecParallel(cat));
+    assert(calls == 2);
+    assert(cat.FindNode("e")->GetValue() == TSetValue(31));
+  }
+
+  {
+    // a <-> x, a -> b -> c, initials a and x are isomorphic
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    Node x("x", Node::EType::eObject);
+    Node b("b", Node::EType::eObject);
+    Node c("c", Node::EType::eObject);
+
+    a.SetValue(1);
+    x.SetValue(5);
+
+    Arrow ax("a", "x", "share_ax");
+    Arrow xa("x", "a", "share_xa");
+    Arrow ab("a", "b", "share_ab2");
+    Arrow bc("b", "c", "share_bc2");
+
+    cat.AddNodes({a, x, b, c});
+    cat.AddArrows({ax, xa, ab, bc});
+
+    cat.SolveCompositions();
+    cat.SolveCompositions();
+
+    reg.Reg<int, int>(ax, [](int arg_) { return arg_ + 1; });
+    reg.Reg<int, int>(xa, [](int arg_) { return arg_ - 1; });
+    reg.Reg<int, int>(ab, [](int arg_) { return arg_ * 2; });
+    reg.Reg<int, int>(bc, [](int arg_) { return arg_ * 10; });
+
+    auto plan = context.GetExecutor().Compile(cat);
+    assert(plan.has_value());
+
+    // Chain from x rewrites a, so the shared part runs again on it
+    assert(plan->hops.size() == 5);
+
+    assert(context.Exec(cat));
+    assert(cat.FindNode("c")->GetValue() == TSetValue(80));
+  }
+}
+} // namespace cat
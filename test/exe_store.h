@@ -0,0 +1,85 @@
+#pragma once
+
+#include <assert.h>
+#include <thread>
+
+#include "../include/node.h"
+#include "execution_context.h"
+#include "value_store.h"
+
+namespace cat {
+//============================================================
+// Testing of value stores
+//============================================================
+void test_exe_store() {
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(3);
+  b.SetValue(0);
+  c.SetValue(0);
+
+  Arrow ab("a", "b", "store_ab");
+  Arrow bc("b", "c", "store_bc");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  const Node &graph = cat;
+  const size_t hash = graph.Hash();
+
+  ExecutionContext first(1);
+  ExecutionContext second(1);
+
+  first.GetRegister().Reg<int, int>(ab, [](int arg_) { return arg_ + 1; });
+  first.GetRegister().Reg<int, int>(bc, [](int arg_) { return arg_ * 2; });
+  second.GetRegister().Reg<int, int>(ab, [](int arg_) { return arg_ - 1; });
+  second.GetRegister().Reg<int, int>(bc, [](int arg_) { return arg_ * 3; });
+
+  auto firstPlan = first.GetExecutor().Compile(graph);
+  auto secondPlan = second.GetExecutor().Compile(graph);
+  assert(firstPlan.has_value() && secondPlan.has_value());
+
+  // Executors share the graph, each with its own store
+  std::optional<ValueStore> firstStore = ValueStore::Load(*firstPlan, graph);
+  std::optional<ValueStore> secondStore =
+      ValueStore::Load(*secondPlan, graph);
+  assert(firstStore.has_value() && secondStore.has_value());
+  assert(firstStore->Size() == 3);
+
+  std::thread worker([&]() {
+    for (int i = 0; i < 100; ++i)
+      assert(second.GetExecutor().Run(*secondPlan, *secondStore));
+  });
+
+  assert(first.GetExecutor().Run(*firstPlan, *firstStore));
+  worker.join();
+
+  assert(firstStore->Find(*firstPlan, "c") == TSetValue(8));
+  assert(secondStore->Find(*secondPlan, "c") == TSetValue(6));
+  assert(!firstStore->Find(*firstPlan, "x").has_value());
+
+  // Graph is untouched
+  assert(graph.Hash() == hash);
+  assert(graph.FindNode("c")->GetValue() == TSetValue(0));
+
+  // Values are changed in place
+  firstStore->Set(firstPlan->Slot("a").value(), 10);
+  assert(first.GetExecutor().Run(*firstPlan, *firstStore));
+  assert(firstStore->Find(*firstPlan, "c") == TSetValue(22));
+
+  firstStore->Store(*firstPlan, cat);
+  assert(cat.FindNode("b")->GetValue() == TSetValue(11));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(22));
+  assert(cat.FindNode("a")->GetValue() == TSetValue(3));
+
+  // Store of another plan is refused
+  ValueStore empty;
+  assert(!first.GetExecutor().Run(*firstPlan, empty));
+}
+} // namespace cat
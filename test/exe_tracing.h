@@ -0,0 +1,118 @@
+#pragma once
+
+#include <assert.h>
+#include <chrono>
+#include <thread>
+
+#include "../include/node.h"
+#include "execution_context.h"
+#include "tracer.h"
+
+namespace cat {
+//============================================================
+// Testing of executor tracing
+//============================================================
+void test_exe_tracing() {
+  {
+    Histogram histogram;
+    assert(histogram.Percentile(50) == 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+      histogram.Record(value);
+
+    assert(histogram.Count() == 1000);
+    assert(histogram.Min() == 1);
+    assert(histogram.Max() == 1000);
+    assert(histogram.Total() == 500500);
+
+    // Percentiles within relative error of buckets
+    uint64_t median = histogram.Percentile(50);
+    assert(median >= 500 && median <= 500 + 500 / 16);
+    assert(histogram.Percentile(100) == 1000);
+    assert(histogram.Percentile(0) == 1);
+
+    Histogram other;
+    other.Record(5000);
+    histogram.Merge(other);
+    assert(histogram.Count() == 1001);
+    assert(histogram.Max() == 5000);
+  }
+
+  ExecutionContext context(2);
+
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(1);
+
+  Arrow ab("a", "b", "trace_fast");
+  Arrow bc("b", "c", "trace_slow");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  context.GetRegister().Reg<int, int>(ab, [](int arg_) { return arg_ + 1; });
+  context.GetRegister().Reg<int, int>(bc, [](int arg_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return arg_ * 2;
+  });
+
+  Executor &executor = context.GetExecutor();
+
+  auto plan = executor.Compile(cat);
+  assert(plan.has_value());
+
+  // Nothing is recorded without tracer
+  Tracer tracer;
+  assert(executor.Run(plan.value(), cat));
+  assert(tracer.GetStats(Tracer::ECategory::eArrow).empty());
+
+  executor.SetTracer(&tracer);
+  assert(executor.GetTracer() == &tracer);
+
+  for (int i = 0; i < 3; ++i)
+    assert(executor.Run(plan.value(), cat));
+
+  auto arrows = tracer.GetStats(Tracer::ECategory::eArrow);
+  assert(arrows.size() == 2);
+  assert(arrows["trace_fast"].calls == 3);
+  assert(arrows["trace_slow"].calls == 3);
+  assert(arrows["trace_slow"].latency.Min() >= 2000000);
+  assert(arrows["trace_slow"].latency.Mean() >
+         arrows["trace_fast"].latency.Mean());
+
+  Tracer::Stats runs = tracer.GetStats(Tracer::ECategory::eRun, "serial");
+  assert(runs.calls == 3);
+  assert(runs.latency.Total() >= arrows["trace_slow"].latency.Total());
+
+  // Events are collected only if enabled
+  assert(tracer.GetEvents().empty());
+
+  tracer.EnableEvents(true);
+  assert(executor.Run(plan.value(), cat, context.GetPool()));
+  assert(tracer.GetStats(Tracer::ECategory::eRun, "parallel").calls == 1);
+
+  auto events = tracer.GetEvents();
+  assert(events.size() == 3);
+  assert(events.back().category == Tracer::ECategory::eRun);
+
+  std::string trace = tracer.ChromeTrace();
+  assert(trace.find("\"traceEvents\"") != std::string::npos);
+  assert(trace.find("\"name\":\"trace_slow\",\"cat\":\"arrow\"") !=
+         std::string::npos);
+  assert(trace.find("\"name\":\"parallel\",\"cat\":\"run\"") !=
+         std::string::npos);
+
+  // Compiling resolves functions of all arrows
+  tracer.Reset();
+  assert(executor.Compile(cat).has_value());
+  assert(tracer.GetStats(Tracer::ECategory::eResolve).size() == 2);
+
+  executor.SetTracer(nullptr);
+}
+} // namespace cat
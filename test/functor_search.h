@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+
+#include "../include/node.h"
+#include "parser.h"
+
+namespace cat {
+//============================================================
+// Testing of functor search
+//============================================================
+void test_functor_search() {
+  auto src = R"(
+LCAT Cat
+{
+   SCAT A
+   {
+      OBJ a0, a1, a2;
+
+      a0 -[*]-> a1 {};
+      a1 -[*]-> a2 {};
+      a0 -[*]-> a2 {};
+   }
+
+   SCAT B
+   {
+      OBJ b0, b1, b2;
+
+      b0 -[*]-> b1 {};
+      b1 -[*]-> b2 {};
+      b0 -[*]-> b2 {};
+   }
+}
+         )";
+
+  Parser prs;
+  prs.ParseSource(src);
+
+  Node ccat = *prs.Data();
+
+  Arrow::List control;
+  for (const Arrow &arrow : ccat.ProposeArrows("A", "B")) {
+    if (ccat.Verify(arrow))
+      control.push_back(arrow);
+  }
+
+  Arrow::List ret = ccat.FindFunctors("A", "B");
+  assert(!ret.empty());
+  assert(ret == control);
+
+  ret = ccat.FindFunctors("A", "B", 2);
+  assert(ret.size() == 2);
+  for (const Arrow &arrow : ret) {
+    assert(ccat.Verify(arrow));
+  }
+
+  assert(ccat.FindFunctors("A", "B", 0).empty());
+  assert(ccat.FindFunctors("A", "C").empty());
+
+  Arrow::List reverse = ccat.FindFunctors("B", "A");
+  control.clear();
+  for (const Arrow &arrow : ccat.ProposeArrows("B", "A")) {
+    if (ccat.Verify(arrow))
+      control.push_back(arrow);
+  }
+
+  assert(reverse == control);
+
+  {
+    // Limited search returns the first of more valid arrows
+    auto wide = R"(
+LCAT Cat
+{
+   SCAT A
+   {
+      OBJ a0, a1;
+
+      a0 -[*]-> a1 {};
+   }
+
+   SCAT C
+   {
+      OBJ c0, c1, c2, c3;
+
+      c0 -[*]-> c1 {};
+      c0 -[*]-> c2 {};
+      c0 -[*]-> c3 {};
+      c1 -[*]-> c2 {};
+      c1 -[*]-> c3 {};
+      c2 -[*]-> c3 {};
+   }
+}
+         )";
+
+    Parser wprs;
+    wprs.ParseSource(wide);
+
+    Node wcat = *wprs.Data();
+
+    control.clear();
+    for (const Arrow &arrow : wcat.ProposeArrows("A", "C")) {
+      if (wcat.Verify(arrow))
+        control.push_back(arrow);
+    }
+    // Arrow a0 -> a1 maps to any arrow of C including identities
+    assert(control.size() == 10);
+
+    for (size_t count = 1; count <= control.size() + 1; ++count) {
+      Arrow::List first(control.begin(),
+                        std::next(control.begin(),
+                                  std::min(count, control.size())));
+      assert(wcat.FindFunctors("A", "C", count) == first);
+    }
+  }
+}
+} // namespace cat
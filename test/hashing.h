@@ -0,0 +1,99 @@
+#pragma once
+
+#include <assert.h>
+#include <unordered_set>
+
+#include "../include/node.h"
+#include "parser.h"
+
+namespace cat {
+//============================================================
+// Testing of structural hashing
+//============================================================
+void test_hashing() {
+  {
+    Arrow left("A", "B");
+    left.EmplaceArrow("a0", "b0");
+    left.EmplaceArrow("a1", "b1");
+
+    Arrow right = left;
+    assert(left.Hash() == right.Hash());
+    assert(left == right);
+
+    right.EraseArrow("a1_b1");
+    assert(left.Hash() != right.Hash());
+    assert(left != right);
+
+    right.EmplaceArrow("a1", "b1");
+    assert(left.Hash() == right.Hash());
+
+    right.SetTarget("C");
+    assert(left.Hash() != right.Hash());
+
+    right.SetTarget("B");
+    right.Inverse();
+    right.Inverse();
+    assert(left.Hash() == right.Hash());
+    assert(left == right);
+  }
+
+  {
+    Arrow left("A", "B", "f");
+    left.EmplaceArrow("a0", "b0");
+    left.EmplaceArrow("a1", "b1");
+
+    Arrow right("A", "B", "g");
+    right.EmplaceArrow("a1", "b1");
+    right.EmplaceArrow("a0", "b0");
+
+    assert(left != right);
+    assert(left.IsAssociative(right));
+    assert(right.IsAssociative(left));
+
+    right.EraseArrow("a0_b0");
+    right.EmplaceArrow("a0", "b1");
+    assert(!left.IsAssociative(right));
+  }
+
+  {
+    std::unordered_set<Arrow, ArrowKeyHasher> unique;
+    unique.insert(Arrow("A", "B"));
+    unique.insert(Arrow("A", "B"));
+    unique.insert(Arrow("A", "C"));
+    assert(unique.size() == 2);
+  }
+
+  {
+    Node left("cat", Node::EType::eSCategory);
+    left.AddNodes({Node("a", Node::EType::eObject),
+                   Node("b", Node::EType::eObject),
+                   Node("c", Node::EType::eObject)});
+    left.AddArrows({Arrow("a", "b"), Arrow("b", "c")});
+
+    Node right("cat", Node::EType::eSCategory);
+    right.AddNodes({Node("c", Node::EType::eObject),
+                    Node("a", Node::EType::eObject),
+                    Node("b", Node::EType::eObject)});
+    right.AddArrows({Arrow("b", "c"), Arrow("a", "b")});
+
+    assert(left.Hash() == right.Hash());
+
+    Node copy = left;
+    assert(copy.Hash() == left.Hash());
+
+    Node value("a", Node::EType::eObject);
+    value.SetValue(10);
+    copy.ReplaceNode(value);
+    assert(copy.Hash() == left.Hash());
+
+    copy.SolveCompositions();
+    assert(copy.Hash() != left.Hash());
+
+    copy.EraseArrow("abc");
+    assert(copy.Hash() == left.Hash());
+
+    copy.EraseNode("c");
+    assert(copy.Hash() != left.Hash());
+  }
+}
+} // namespace cat
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <assert.h>
+#include <string>
+
+#include "../include/node.h"
+#include "counters.h"
+
+namespace cat {
+namespace {
+std::size_t g_hook_allocated{};
+std::size_t g_hook_deallocated{};
+
+void memory_hook(std::size_t bytes_, bool allocated_) {
+  (allocated_ ? g_hook_allocated : g_hook_deallocated) += bytes_;
+}
+} // namespace
+
+//============================================================
+// Testing of memory reports and allocation hook
+//============================================================
+void test_node_memory() {
+  {
+    Node cat("cat", Node::EType::eSCategory);
+
+    MemoryUsage usage = cat.MemoryReport();
+    assert(usage.Total() == 0);
+
+    cat.AddNode(Node("a", Node::EType::eObject));
+    cat.AddNode(Node("b", Node::EType::eObject));
+
+    usage = cat.MemoryReport();
+    assert(usage.nodes > 0);
+    assert(usage.arrows > 0);
+    assert(usage.values == 0);
+
+    cat.AddArrow(Arrow("a", "b"));
+
+    // Arrow entry and copy of target in codomain
+    MemoryUsage connected = cat.MemoryReport();
+    assert(connected.nodes > usage.nodes);
+    assert(connected.arrows > usage.arrows);
+
+    // Long names don't fit into strings themselves
+    std::string name(64, 'n');
+    cat.AddNode(Node(name, Node::EType::eObject));
+    assert(cat.MemoryReport().names >= 2 * name.size());
+  }
+
+  {
+    // Values
+    Node cat("cat", Node::EType::eSCategory);
+
+    Node a("a", Node::EType::eObject);
+    a.SetValue(std::string(100, 'v'));
+
+    cat.AddNode(a);
+    assert(cat.MemoryReport().values >= 100);
+  }
+
+  {
+    // Tensor buffer shared by nodes is counted once
+    Tensor tensor(std::vector<double>(1000, 1.0));
+
+    Node shared("shared", Node::EType::eSCategory);
+    Node copied("copied", Node::EType::eSCategory);
+
+    for (const char *name : {"a", "b"}) {
+      Node obj(name, Node::EType::eObject);
+
+      obj.SetValue(tensor);
+      shared.AddNode(obj);
+
+      obj.SetValue(tensor.Transform([](double x_) { return x_; }));
+      copied.AddNode(obj);
+    }
+
+    std::size_t buffer = 1000 * sizeof(double);
+
+    assert(shared.MemoryReport().values >= buffer);
+    assert(shared.MemoryReport().values < 2 * buffer);
+    assert(copied.MemoryReport().values >= 2 * buffer);
+  }
+
+  {
+    // Functors with the same mapping share it after interning
+    Node lcat("lcat", Node::EType::eLCategory);
+
+    for (const char *name : {"A", "B"}) {
+      Node scat(name, Node::EType::eSCategory);
+      scat.AddNode(Node("x", Node::EType::eObject));
+      lcat.AddNode(scat);
+    }
+
+    Arrow first("A", "B", "first");
+    first.EmplaceArrow("x", "x");
+    assert(lcat.AddArrow(first));
+
+    MemoryUsage usage = lcat.MemoryReport();
+    assert(usage.mappings > 0);
+
+    Arrow second("A", "B", "second");
+    second.EmplaceArrow("x", "x");
+    assert(lcat.AddArrow(second));
+
+    assert(lcat.MemoryReport().mappings == usage.mappings);
+  }
+
+  {
+    // Allocation hook and counters see containers of nodes
+    bool counting = get_counting();
+    set_counting(true);
+    reset_counters();
+
+    g_hook_allocated = g_hook_deallocated = 0;
+    set_allocation_hook(memory_hook);
+
+    {
+      Node cat("cat", Node::EType::eSCategory);
+      cat.AddNode(Node("a", Node::EType::eObject));
+      cat.AddNode(Node("b", Node::EType::eObject));
+      cat.AddArrow(Arrow("a", "b"));
+
+      assert(g_hook_allocated > 0);
+    }
+
+    set_allocation_hook(nullptr);
+
+    // Everything allocated by containers is released
+    assert(g_hook_allocated == g_hook_deallocated);
+    assert(get_counter(ECounter::eAllocatedBytes) == g_hook_allocated);
+    assert(get_counter(ECounter::eAllocations) > 0);
+
+    reset_counters();
+    set_counting(counting);
+  }
+}
+} // namespace cat
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../include/node.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of concurrent register access
+//============================================================
+void test_register_concurrent() {
+  Arrow ab("a", "b", "conc_fn");
+
+  Register::Inst().Reg(ab, [](TSetValue) { return TSetValue(1); });
+
+  // Snapshots don't change with later registrations
+  Register::TSnapshot snapshot = Register::Inst().Snapshot();
+  size_t generation = Register::Inst().Generation();
+
+  Register::Inst().Reg(ab, [](TSetValue) { return TSetValue(2); });
+  assert(Register::Inst().Generation() != generation);
+
+  const Register::Entry *entry = Register::Find(snapshot, ab);
+  assert(entry && entry->fn(0) == TSetValue(1));
+  assert(Register::Inst().Get(ab)(0) == TSetValue(2));
+  assert(!Register::Find(snapshot, Arrow("x", "y", "conc_none")));
+
+  // Readers always see one of the registered functions while a writer
+  // replaces them
+  std::atomic<bool> stop{};
+  std::atomic<size_t> reads{};
+  std::vector<std::thread> readers;
+
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([&]() {
+      while (!stop) {
+        int value = std::get<(int)ESetTypes::eInt>(Register::Inst().Get(ab)(0));
+        assert(value >= 1 && value <= 1000);
+        ++reads;
+      }
+    });
+  }
+
+  for (int i = 1; i <= 1000; ++i) {
+    if (i % 2)
+      Register::Inst().Reg(ab, [i](TSetValue) { return TSetValue(i); });
+    else
+      Register::Inst().Reg<int, int>(ab, [i](int) { return i; });
+  }
+
+  while (reads < 1000)
+    std::this_thread::yield();
+
+  stop = true;
+  for (auto &reader : readers)
+    reader.join();
+
+  assert(Register::Inst().Get(ab)(0) == TSetValue(1000));
+  assert(Register::Inst().GetSignature(ab).has_value());
+
+  Register::Inst().Unreg(ab);
+  assert(!Register::Find(Register::Inst().Snapshot(), ab));
+  assert(Register::Inst().Get(ab)(7) == TSetValue(7));
+
+  // Internal arrows don't take part in lookups, as in the maps of register
+  Arrow first("A", "B", "conc_functor");
+  first.EmplaceArrow("a0", "b0");
+  Arrow second("A", "B", "conc_functor");
+  second.EmplaceArrow("a0", "b1");
+
+  Register::Inst().Reg(first, [](TSetValue) { return TSetValue(1); });
+  assert(Register::Inst().Get(second)(0) == TSetValue(1));
+
+  Register::Inst().Reg(second, [](TSetValue) { return TSetValue(2); });
+  assert(Register::Inst().Get(first)(0) == TSetValue(2));
+
+  Register::Inst().Unreg(second);
+  assert(!Register::Find(Register::Inst().Snapshot(), first));
+  assert(Register::Inst().Get(first)(7) == TSetValue(7));
+
+  {
+    // Alternating registers keep seeing their own latest functions, also
+    // when there are more of them than cached snapshots
+    std::vector<std::unique_ptr<Register>> regs;
+    for (int i = 0; i < 6; ++i) {
+      regs.push_back(std::make_unique<Register>());
+      regs.back()->Reg(ab, [i](TSetValue) { return TSetValue(i); });
+    }
+
+    for (int round = 0; round < 3; ++round) {
+      for (int i = 0; i < 6; ++i) {
+        assert(regs[i]->Get(ab)(0) == TSetValue(i + round * 10));
+        regs[i]->Reg(ab, [i, round](TSetValue) {
+          return TSetValue(i + (round + 1) * 10);
+        });
+      }
+    }
+  }
+}
+} // namespace cat
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <assert.h>
+#include <limits>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "memo.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of memoization of arrow functions
+//============================================================
+void test_register_memo() {
+  {
+    Memo memo(2);
+
+    assert(!memo.Find(1).has_value());
+    memo.Insert(1, 10);
+    memo.Insert(2, 20);
+    assert(memo.Find(1) == TSetValue(10));
+
+    // Least recently used result is evicted
+    memo.Insert(3, 30);
+    assert(!memo.Find(2).has_value());
+    assert(memo.Find(1) == TSetValue(10));
+    assert(memo.Find(3) == TSetValue(30));
+
+    // Values of different types are different arguments
+    assert(!memo.Find(1.0).has_value());
+
+    Memo::Stats stats = memo.GetStats();
+    assert(stats.hits == 3);
+    assert(stats.misses == 3);
+    assert(stats.evictions == 1);
+    assert(stats.size == 2);
+    assert(stats.HitRate() == 0.5);
+
+    memo.Clear();
+    assert(memo.GetStats().size == 0);
+    assert(memo.GetStats().HitRate() == 0.0);
+  }
+
+  {
+    // NaN is never found, its results are not kept
+    Memo memo(2);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int i = 0; i < 8; ++i)
+      memo.Insert(nan, i);
+
+    assert(!memo.Find(nan).has_value());
+    assert(memo.GetStats().size == 0);
+    assert(memo.GetStats().evictions == 0);
+
+    memo.Insert(1, 10);
+    memo.Insert(2, 20);
+    assert(memo.Find(1) == TSetValue(10));
+    assert(memo.Find(2) == TSetValue(20));
+  }
+
+  Arrow ab("a", "b", "memo_sqr");
+  Arrow bc("b", "c", "memo_incr");
+
+  int calls{};
+  Register::Inst().Reg(ab, [&](TSetValue val) {
+    ++calls;
+    int arg = std::get<(int)ESetTypes::eInt>(val);
+    return arg * arg;
+  });
+  Register::Inst().Reg<int, int>(bc, [&](int arg_) {
+    ++calls;
+    return arg_ + 1;
+  });
+
+  assert(!Register::Inst().GetMemoStats(ab).has_value());
+  assert(!Register::Inst().Memoize(Arrow("x", "y", "memo_none"), 4));
+
+  assert(Register::Inst().Memoize(ab, 4));
+  assert(Register::Inst().Memoize(bc, 4));
+
+  for (int arg : {2, 3, 2, 2, 3}) {
+    assert(Register::Inst().Get(ab)(arg) == TSetValue(arg * arg));
+  }
+  assert(calls == 2);
+
+  auto stats = Register::Inst().GetMemoStats(ab);
+  assert(stats->hits == 3);
+  assert(stats->misses == 2);
+
+  // Executor goes through memoized typed functions
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(2);
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+
+  calls = 0;
+  for (int i = 0; i < 3; ++i) {
+    assert(Executor::Inst().Run(plan.value(), cat));
+    assert(cat.FindNode("c")->GetValue() == TSetValue(5));
+  }
+  assert(calls == 1);
+  assert(Register::Inst().GetMemoStats(bc)->hits == 2);
+
+  // Registration drops the memo
+  Register::Inst().Reg(ab, [&](TSetValue val) {
+    ++calls;
+    return val;
+  });
+  assert(!Register::Inst().GetMemoStats(ab).has_value());
+
+  Register::Inst().Unmemoize(bc);
+  assert(!Register::Inst().GetMemoStats(bc).has_value());
+
+  calls = 0;
+  Register::Inst().Get(bc)(1);
+  Register::Inst().Get(bc)(1);
+  assert(calls == 2);
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+}
+} // namespace cat
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../include/node.h"
+#include "executor.h"
+#include "register.h"
+
+namespace cat {
+//============================================================
+// Testing of typed registration
+//============================================================
+void test_register_typed() {
+  static_assert(set_type<double>() == ESetTypes::eDouble);
+  static_assert(set_type<int>() == ESetTypes::eInt);
+  static_assert(set_type<std::string>() == ESetTypes::eString);
+
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  a.SetValue(3);
+
+  Arrow ab("a", "b", "typed_half");
+  Arrow bc("b", "c", "typed_str");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  Register::Inst().Reg<int, double>(ab, [](int arg_) { return arg_ / 2.0; });
+  Register::Inst().Reg<double, std::string>(
+      bc, [](double arg_) { return std::to_string(arg_); });
+
+  auto signature = Register::Inst().GetSignature(ab);
+  assert(signature.has_value());
+  assert(signature->arg == ESetTypes::eInt);
+  assert(signature->ret == ESetTypes::eDouble);
+  assert(Register::Inst().GetInvoker(bc));
+
+  // Typed functions still work through the generic interface
+  assert(Register::Inst().Get(ab)(TSetValue(5)) == TSetValue(2.5));
+
+  auto plan = Executor::Inst().Compile(cat);
+  assert(plan.has_value());
+
+  assert(Executor::Inst().Run(plan.value(), cat));
+  assert(cat.FindNode("b")->GetValue() == TSetValue(1.5));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(std::to_string(1.5)));
+
+  // Typed functions are batch kernels
+  Executor::TBatch inputs;
+  inputs["a"] = std::vector<int>{1, 4};
+  auto ret = Executor::Inst().RunBatch(plan.value(), cat, inputs);
+  assert(ret.has_value());
+  assert(std::get<std::vector<double>>(ret->at("b")) ==
+         std::vector<double>({0.5, 2.0}));
+
+  // Value of other type is reported instead of throwing
+  cat.SetNodeValue("a", 3.0);
+  assert(!Executor::Inst().Run(plan.value(), cat));
+
+  // Input values don't take part in compilation, they are checked by runs
+  auto unset = cat;
+  unset.SetNodeValue("a", TSetValue());
+  assert(Executor::Inst().Compile(unset).has_value());
+  assert(Executor::Inst().Compile(cat).has_value());
+
+  // Types along the sequence are checked at compile time
+
+  cat.SetNodeValue("a", 3);
+  Register::Inst().Reg<int, int>(bc, [](int arg_) { return arg_ + 1; });
+  assert(!Executor::Inst().Compile(cat).has_value());
+
+  // Untyped registration drops the signature
+  Register::Inst().Reg(bc, [](TSetValue val) { return val; });
+  assert(!Register::Inst().GetSignature(bc).has_value());
+  assert(Executor::Inst().Compile(cat).has_value());
+
+  Register::Inst().Unreg(ab);
+  Register::Inst().Unreg(bc);
+  assert(!Register::Inst().GetSignature(ab).has_value());
+}
+} // namespace cat
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+
+#include "../include/node.h"
+#include "../include/solver_control.h"
+#include "parser.h"
+
+namespace cat {
+//============================================================
+// Testing of solver limits
+//============================================================
+void test_solver_control() {
+  auto src = R"(
+LCAT Cat
+{
+   SCAT A
+   {
+      OBJ a0, a1, a2;
+   }
+
+   SCAT B
+   {
+      OBJ b0, b1;
+   }
+
+   SCAT C
+   {
+      OBJ c0, c1;
+   }
+
+   A -[*]-> B
+   {
+      a0 -[*]-> b0 {};
+      a1 -[*]-> b1 {};
+      a2 -[*]-> b1 {};
+   }
+
+   A -[*]-> C
+   {
+      a0 -[*]-> c0 {};
+      a1 -[*]-> c1 {};
+      a2 -[*]-> c1 {};
+   }
+}
+         )";
+
+  Parser prs;
+  prs.ParseSource(src);
+
+  Node ccat = *prs.Data();
+
+  {
+    SolverControl control;
+
+    Arrow::List ret = ccat.ProposeArrows("A", "B", &control);
+    assert(ret.size() == 8);
+    assert(!control.IsTruncated());
+    assert(control.Operations() == 8);
+  }
+
+  {
+    SolverControl control;
+    control.SetBudget(3);
+
+    Arrow::List ret = ccat.ProposeArrows("A", "B", &control);
+    assert(ret.size() == 3);
+    assert(control.IsTruncated());
+
+    Arrow::List full = ccat.ProposeArrows("A", "B");
+    assert(std::equal(ret.begin(), ret.end(), full.begin()));
+  }
+
+  {
+    SolverControl control;
+    control.Cancel();
+
+    assert(ccat.ProposeArrows("A", "B", &control).empty());
+    assert(control.IsTruncated());
+  }
+
+  {
+    SolverControl control;
+    control.SetDeadline(SolverControl::TClock::now());
+
+    assert(ccat.SolveDetermination("A_B", "A_C", &control).empty());
+    assert(control.IsTruncated());
+  }
+
+  {
+    SolverControl control;
+    control.SetTimeout(std::chrono::hours(1));
+
+    assert(ccat.SolveDetermination("A_B", "A_C", &control).size() == 1);
+    assert(!control.IsTruncated());
+  }
+
+  {
+    SolverControl control;
+    control.SetBudget(1);
+
+    assert(ccat.SolveChoice("A_B", "A_C", &control).empty());
+    assert(control.IsTruncated());
+  }
+
+  {
+    Node scat("scat", Node::EType::eSCategory);
+    scat.AddNodes({Node("a", Node::EType::eObject),
+                   Node("b", Node::EType::eObject),
+                   Node("c", Node::EType::eObject)});
+    scat.AddArrows({Arrow("a", "b"), Arrow("b", "c"), Arrow("a", "c")});
+
+    assert(scat.SolveSequences("a", "c").size() == 2);
+
+    SolverControl control;
+    control.SetBudget(2);
+
+    auto ret = scat.SolveSequences("a", "c", std::optional<size_t>(), &control);
+    assert(ret.size() < 2);
+    assert(control.IsTruncated());
+  }
+}
+} // namespace cat
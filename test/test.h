@@ -13,20 +13,43 @@
 #include "arrow_composition.h"
 #include "arrow_deletion.h"
 #include "arrow_generator.h"
+#include "arrow_interning.h"
 #include "arrow_inversion.h"
 #include "arrow_query.h"
 #include "arrow_query_on_node.h"
 #include "arrow_sequence.h"
 #include "arrow_validation.h"
 #include "choice.h"
+#include "complexity.h"
 #include "determination.h"
+#include "exe_async.h"
+#include "exe_batch.h"
+#include "exe_checkpoint.h"
+#include "exe_context.h"
+#include "exe_fusion.h"
+#include "exe_hierarchy.h"
+#include "exe_incremental.h"
+#include "exe_parallel.h"
+#include "exe_pipeline.h"
+#include "exe_plan.h"
 #include "exe_run.h"
+#include "exe_sharing.h"
+#include "exe_store.h"
+#include "exe_tracing.h"
+#include "functor_search.h"
+#include "hashing.h"
 #include "node_addition.h"
 #include "node_deletion.h"
 #include "node_initial_terminal.h"
+#include "node_memory.h"
 #include "node_query.h"
 #include "node_query_by_arrow.h"
 #include "parsing.h"
+#include "register_concurrent.h"
+#include "register_memo.h"
+#include "register_typed.h"
+#include "solver_control.h"
+#include "value_tensor.h"
 
 #include "parser.h"
 
@@ -80,6 +103,52 @@ void test() {
 
   test_choice();
 
+  test_functor_search();
+
+  test_solver_control();
+
+  test_hashing();
+
+  test_arrow_interning();
+
+  test_exe_plan();
+
+  test_exe_parallel();
+
+  test_exe_batch();
+
+  test_register_typed();
+
+  test_exe_fusion();
+
+  test_exe_incremental();
+
+  test_register_memo();
+
+  test_pipeline();
+
+  test_exe_async();
+
+  test_register_concurrent();
+
+  test_exe_context();
+
+  test_exe_tracing();
+
+  test_exe_sharing();
+
+  test_exe_store();
+
+  test_value_tensor();
+
+  test_exe_checkpoint();
+
+  test_exe_hierarchy();
+
+  test_complexity();
+
+  test_node_memory();
+
   print_info("End test");
 
   set_log_mode(lmode);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <assert.h>
+#include <numeric>
+
+#include "../include/node.h"
+#include "execution_context.h"
+#include "tensor.h"
+
+namespace cat {
+//============================================================
+// Testing of tensor values
+//============================================================
+void test_value_tensor() {
+  static_assert(set_type<Tensor>() == ESetTypes::eTensor);
+
+  {
+    std::vector<double> data(12);
+    std::iota(data.begin(), data.end(), 0.0);
+
+    auto tensor = Tensor::Create(data, {3, 4});
+    assert(tensor.has_value());
+    assert(tensor->Rank() == 2);
+    assert(tensor->Size() == 12);
+    assert(tensor->At({1, 2}) == 6.0);
+    assert(!tensor->At({3, 0}).has_value());
+    assert(!Tensor::Create(data, {5, 4}).has_value());
+
+    // Slices and reshapes share the buffer
+    auto rows = tensor->Slice(1, 3);
+    assert(rows.has_value());
+    assert(rows->Shape() == Tensor::TShape({2, 4}));
+    assert(rows->SharesBuffer(tensor.value()));
+    assert((*rows)[0] == 4.0);
+    assert(rows->At({1, 3}) == 11.0);
+    assert(!tensor->Slice(2, 4).has_value());
+
+    auto flat = rows->Reshape({8});
+    assert(flat.has_value());
+    assert(flat->SharesBuffer(tensor.value()));
+    assert(flat->ToVector() ==
+           std::vector<double>({4, 5, 6, 7, 8, 9, 10, 11}));
+    assert(!rows->Reshape({3}).has_value());
+
+    // Equality by shape and elements
+    assert(flat.value() == Tensor({4, 5, 6, 7, 8, 9, 10, 11}));
+    assert(flat.value() != rows.value());
+    assert(std::hash<Tensor>()(flat.value()) ==
+           std::hash<Tensor>()(Tensor({4, 5, 6, 7, 8, 9, 10, 11})));
+
+    Tensor doubled = flat->Transform([](double x_) { return x_ * 2; });
+    assert(!doubled.SharesBuffer(flat.value()));
+    assert(doubled[7] == 22.0);
+    assert(Tensor().Size() == 0);
+  }
+
+  ExecutionContext context(2);
+
+  Node cat("cat", Node::EType::eSCategory);
+
+  Node a("a", Node::EType::eObject);
+  Node b("b", Node::EType::eObject);
+  Node c("c", Node::EType::eObject);
+
+  const size_t size = 1000000;
+  Tensor samples(std::vector<double>(size, 1.0));
+  a.SetValue(samples);
+
+  Arrow ab("a", "b", "tensor_half");
+  Arrow bc("b", "c", "tensor_sum");
+
+  cat.AddNodes({a, b, c});
+  cat.AddArrows({ab, bc});
+
+  cat.SolveCompositions();
+
+  // Elements flow between nodes without copies
+  context.GetRegister().Reg<Tensor, Tensor>(
+      ab, [](Tensor arg_) { return arg_.Slice(0, arg_.Size() / 2).value(); });
+  context.GetRegister().Reg<Tensor, double>(bc, [](Tensor arg_) {
+    return std::accumulate(arg_.begin(), arg_.end(), 0.0);
+  });
+
+  assert(context.Exec(cat));
+
+  const auto &half = std::get<Tensor>(cat.FindNode("b")->GetValue());
+  assert(half.Size() == size / 2);
+  assert(half.SharesBuffer(samples));
+  assert(cat.FindNode("c")->GetValue() == TSetValue(double(size / 2)));
+
+  // Tensors are memoized by value
+  context.GetRegister().Memoize(bc, 4);
+  assert(context.GetRegister().Get(bc)(half) == TSetValue(double(size / 2)));
+  assert(context.GetRegister().Get(bc)(half) == TSetValue(double(size / 2)));
+  assert(context.GetRegister().GetMemoStats(bc)->hits == 1);
+}
+} // namespace cat